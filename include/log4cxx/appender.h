@@ -28,6 +28,7 @@ namespace log4cxx
     // Forward declarations
     namespace spi {
         class LoggingEvent;
+        typedef std::vector<const LoggingEvent *> LoggingEventList;
         
         class Filter;
         typedef helpers::ObjectPtr<Filter> FilterPtr;
@@ -85,6 +86,14 @@ namespace log4cxx
         */
         virtual void doAppend(const spi::LoggingEvent& event) = 0;
 
+        /**
+         Log a batch of events in <code>Appender</code> specific way.
+         This has the same effect as calling <code>doAppend</code> for
+         each event, but lets the appender take its lock and flush its
+         output only once for the whole batch.
+        */
+        virtual void doAppendBatch(const spi::LoggingEventList& events) = 0;
+
 
         /**
          Get the name of this appender. The name uniquely identifies the
@@ -22,6 +22,9 @@
 #include <log4cxx/spi/errorhandler.h>
 #include <log4cxx/spi/filter.h>
 #include <log4cxx/helpers/objectimpl.h>
+#include <log4cxx/helpers/threadspecificdata.h>
+#include <log4cxx/helpers/atomic.h>
+#include <log4cxx/helpers/hazardpointer.h>
 
 namespace log4cxx
 {
@@ -51,8 +54,9 @@ namespace log4cxx
 		tstring name;
 
 		/**
-		There is no level threshold filtering by default.  */
-		const Level * threshold;
+		There is no level threshold filtering by default. Read without
+		the appender lock, and published with helpers::Atomic. */
+		const Level * volatile threshold;
 
 		/**
 		It is assumed and enforced that errorHandler is never null.
@@ -66,13 +70,39 @@ namespace log4cxx
 		/** The last filter in the filter chain. */
 		spi::FilterPtr tailFilter;
 
+		/** The filter chain, as compiled by #compileFilters. The
+		table is replaced as a whole and read without locking. */
+		struct CompiledFilters;
+		CompiledFilters * volatile compiledFilters;
+
+		/** The tables replaced by #compileFilters, deleted once no
+		reader protects them. */
+		helpers::RetiredList<CompiledFilters> retiredFilters;
+
 		/**
 		Is this appender closed?
 		*/
 		bool closed;
 
+		/** Incremented each time the threshold of an appender
+		changes, so that the loggers build their routes again. */
+		static volatile long thresholdGeneration;
+
+		/** Initial capacity of the format buffers. */
+		static int BUF_SIZE;
+
+		/** Format buffers growing beyond this capacity are released
+		after use. */
+		static int MAX_CAPACITY;
+
+	private:
+		/** Buffer of each thread the events are formatted into by
+		#prepare. */
+		static helpers::ThreadSpecificData formatBuffer;
+
 	public:
 		AppenderSkeleton();
+		~AppenderSkeleton();
 
 		/**
 		Finalize this appender by calling the derived class'
@@ -82,18 +112,31 @@ namespace log4cxx
 
 	public:
 		/**
-		Derived appenders should override this method if option structure
-		requires it.
+		Attach the filters to this appender and compile the chain, so
+		that the options set on the filters after they were added take
+		effect. Derived appenders overriding this method must call it.
 		*/
-		void activateOptions() {}
+		void activateOptions();
 		void setOption(const tstring& name, const tstring& value) {}
 
 		/**
-		Add a filter to end of the filter list.
+		Add a filter to end of the filter list, and compile the chain.
 		*/
 	public:
 		void addFilter(spi::FilterPtr newFilter) ;
 
+		/**
+		Compile the filter chain. For each predefined level, the
+		decisions of the filters which only depend on the level are
+		computed once, so that only the other filters are called for
+		each event. The chain is compiled again by #activateOptions,
+		after the options of the filters which were already added were
+		set. The compiled chain is published with an atomic pointer
+		swap, concurrent events use either the previous or the new one.
+		*/
+	public:
+		void compileFilters();
+
 		/**
 		Subclasses of <code>AppenderSkeleton</code> should implement this
 		method to perform actual logging. See also AppenderSkeleton::doAppend
@@ -103,7 +146,46 @@ namespace log4cxx
 		virtual void append(const spi::LoggingEvent& event) = 0;
 
 		/**
-		Clear the filters chain.
+		Called by AppenderSkeleton#doAppendBatch with the events which
+		passed the threshold and the filters. The default implementation
+		calls #append for each event. Subclasses can override it to
+		process the whole batch at once.
+		*/
+		virtual void appendBatch(const spi::LoggingEventList& events);
+
+		/**
+		First phase of the append, called by #doAppend without holding
+		the appender lock once the event passed the threshold and the
+		filters. Subclasses can override it to append the formatted
+		event to <code>output</code>, so that the CPU intensive
+		formatting of concurrent events is done in parallel, and return
+		<code>true</code>. The default implementation returns
+		<code>false</code>, in which case #append is called while
+		holding the lock.
+		*/
+		virtual bool prepare(const spi::LoggingEvent& /* event */,
+			tstring& /* output */)
+			{ return false; }
+
+		/**
+		Second phase of the append, called by #doAppend while holding
+		the appender lock with the text produced by #prepare. Subclasses
+		overriding #prepare must override it to write
+		<code>formatted</code> to their output.
+		*/
+		virtual void commit(const spi::LoggingEvent& /* event */,
+			const tstring& /* formatted */) {}
+
+		/**
+		Flush the filters, then detach them from this appender, so that
+		the events they hold back are appended before the appender is
+		closed. Subclasses call it at the start of <code>close</code>,
+		without holding the appender lock.
+		*/
+		void closeFilters();
+
+		/**
+		Flush and clear the filters chain.
 		*/
 	public:
 		void clearFilters();
@@ -147,7 +229,9 @@ namespace log4cxx
 		method for the meaning of this option.
 		*/
 	public:
-		const Level& getThreshold() { return *threshold; }
+		const Level& getThreshold()
+			{ return *(const Level *)helpers::Atomic::getPointer(
+				(void * const volatile *)&threshold); }
 
 		/**
 		Check whether the message level is below the appender's
@@ -162,10 +246,30 @@ namespace log4cxx
 		* This method performs threshold checks and invokes filters before
 		* delegating actual logging to the subclasses specific
 		* AppenderSkeleton#append method.
+		*
+		* <p>The threshold, the filters and AppenderSkeleton#prepare are
+		* called without holding the appender lock. The lock is only
+		* taken to write the event with AppenderSkeleton#commit or
+		* AppenderSkeleton#append.
 		* */
 	public:
 		void doAppend(const spi::LoggingEvent& event);
 
+		/**
+		Check the threshold and the filter chain. Returns
+		<code>true</code> if <code>event</code> should be appended.
+		*/
+	protected:
+		bool isAccepted(const spi::LoggingEvent& event);
+
+		/**
+		This method takes the appender lock once, performs threshold
+		checks and invokes filters on each event, then delegates the
+		accepted events to the AppenderSkeleton#appendBatch method.
+		*/
+	public:
+		void doAppendBatch(const spi::LoggingEventList& events);
+
 		/**
 		Set the {@link spi::ErrorHandler ErrorHandler} for this Appender.
 		*/
@@ -177,9 +281,12 @@ namespace log4cxx
 		their own (fixed) layouts or do not use one. For example, the
 		{@link net::SocketAppender SocketAppender} ignores the layout set
 		here.
+
+		<p>The layout is replaced while holding the appender lock, the
+		events being formatted keep the previous one.
 		*/
 	public:
-		void setLayout(LayoutPtr layout) { this->layout = layout; }
+		void setLayout(LayoutPtr layout);
 
 		/**
 		Set the name of this Appender.
@@ -197,7 +304,13 @@ namespace log4cxx
 		string, such as "DEBUG", "INFO" and so on.
 		*/
 	public:
-		void setThreshold(const Level& threshold) { this->threshold = &threshold; }
+		void setThreshold(const Level& threshold);
+
+		/**
+		Returns the number of threshold changes of all the appenders.
+		*/
+		static inline long getThresholdGeneration()
+			{ return helpers::Atomic::get(&thresholdGeneration); }
 		
 	}; // class AppenderSkeleton
 }; // namespace log4cxx
@@ -20,6 +20,9 @@
 #include <log4cxx/appenderskeleton.h>
 #include <log4cxx/helpers/appenderattachableimpl.h>
 #include <log4cxx/helpers/thread.h>
+#include <log4cxx/helpers/semaphore.h>
+#include <log4cxx/helpers/loggingeventpool.h>
+#include <time.h>
 
 namespace log4cxx
 {
@@ -27,6 +30,9 @@ namespace log4cxx
 	{
 		class BoundedFIFO;
 		typedef ObjectPtr<BoundedFIFO> BoundedFIFOPtr;
+
+		class RingBuffer;
+		typedef ObjectPtr<RingBuffer> RingBufferPtr;
 	};
 
 	class Dispatcher;
@@ -42,6 +48,21 @@ namespace log4cxx
 	<p>The AsyncAppender uses a separate thread to serve the events in
 	its bounded buffer.
 
+	<p>By default the bounded buffer is a helpers::BoundedFIFO protected
+	by a lock. When the <b>LockFree</b> option is set, a
+	helpers::RingBuffer is used instead: logging threads then neither
+	take the appender lock nor the buffer lock, which keeps their latency
+	flat when many threads log concurrently.
+
+	<p>The <b>OverflowPolicy</b> option selects what happens when the
+	buffer is full: wait for free space (the default), drop the new
+	event, drop the oldest buffered event, or drop only the events below
+	the <b>DiscardThreshold</b> level. Discarded events are counted and
+	a "N events discarded" summary event is dispatched to the attached
+	appenders at most every <b>SummaryInterval</b> seconds, at the
+	level of the most severe discarded event and at least at
+	<code>WARN</code> level.
+
 	<p><b>Important note:</b> The <code>AsyncAppender</code> can only
 	be script configured using the {@link xml::DOMConfigurator DOMConfigurator}.
 	*/
@@ -55,14 +76,57 @@ namespace log4cxx
 		/** The default buffer size is set to 128 events. */
 		static int DEFAULT_BUFFER_SIZE;
 
+		/** The default summary interval is set to 10 seconds. */
+		static long DEFAULT_SUMMARY_INTERVAL;
+
+		/** What to do with an event when the buffer is full. */
+		enum OverflowPolicy
+		{
+			/** Wait until the dispatcher frees a slot. */
+			BLOCK,
+			/** Discard the event being appended. */
+			DROP_NEWEST,
+			/** Discard the oldest buffered event to make room. */
+			DROP_OLDEST,
+			/** Discard the event if its level is below the
+			<b>DiscardThreshold</b>, otherwise wait. */
+			DISCARD_BELOW_LEVEL
+		};
+
 		helpers::BoundedFIFOPtr bf;
-		Dispatcher * dispatcher;
+		helpers::RingBufferPtr rb;
+		Dispatcher * volatile dispatcher;
 		bool locationInfo;
 		bool interruptedWarningMessage;
+		bool lockFree;
+		int overflowPolicy;
+		const Level * discardThreshold;
+		long summaryInterval;
 
 		AsyncAppender();
 		~AsyncAppender();
 
+		/**
+		Start the dispatcher thread if it is not running yet. The
+		dispatcher is otherwise started by the first logging event.
+		*/
+		void activateOptions();
+
+		void setOption(const tstring& option, const tstring& value);
+
+		/**
+		In <b>LockFree</b> mode, threshold and filters are checked
+		without taking the appender lock, then the event is copied into
+		the helpers::RingBuffer. Otherwise this method behaves as
+		AppenderSkeleton#doAppend.
+		*/
+		void doAppend(const spi::LoggingEvent& event);
+
+		/**
+		Queue each event of the batch with #doAppend.
+		*/
+		void doAppendBatch(const spi::LoggingEventList& events);
+
 		void append(const spi::LoggingEvent& event);
 
 		/**
@@ -104,7 +168,8 @@ namespace log4cxx
 		* buffer. Increasing the size of the buffer is always
 		* safe. However, if an existing buffer holds unwritten elements,
 		* then <em>decreasing the buffer size will result in event
-		* loss.</em> Nevertheless, while script configuring the
+		* loss:</em> the oldest events which do not fit are discarded
+		* and reported as such. Nevertheless, while script configuring the
 		* AsyncAppender, it is safe to set a buffer size smaller than the
 		* {@link #DEFAULT_BUFFER_SIZE default buffer size} because
 		* configurators guarantee that an appender cannot be used before
@@ -116,27 +181,148 @@ namespace log4cxx
 		Returns the current value of the <b>BufferSize</b> option.
 		*/
 		int getBufferSize();
+
+		/**
+		The <b>LockFree</b> option takes a boolean value. When set to
+		<code>true</code>, events are queued in a lock-free
+		helpers::RingBuffer instead of the helpers::BoundedFIFO. The
+		option is set to <code>false</code> by default and must be set
+		before the dispatcher is started.
+		*/
+		void setLockFree(bool lockFree);
+
+		/**
+		Returns the current value of the <b>LockFree</b> option.
+		*/
+		inline bool getLockFree() const
+			{ return lockFree; }
+
+		/**
+		The <b>OverflowPolicy</b> option takes one of the values
+		<code>Block</code>, <code>DropNewest</code>,
+		<code>DropOldest</code> or <code>DiscardBelowLevel</code>.
+		See #OverflowPolicy. It is set to <code>Block</code> by default.
+		*/
+		inline void setOverflowPolicy(int overflowPolicy)
+			{ this->overflowPolicy = overflowPolicy; }
+
+		/**
+		Returns the current value of the <b>OverflowPolicy</b> option.
+		*/
+		inline int getOverflowPolicy() const
+			{ return overflowPolicy; }
+
+		/**
+		The <b>DiscardThreshold</b> option takes a level. With the
+		<code>DiscardBelowLevel</code> overflow policy, events below
+		this level are discarded when the buffer is full. It is set to
+		<code>WARN</code> by default.
+		*/
+		inline void setDiscardThreshold(const Level& discardThreshold)
+			{ this->discardThreshold = &discardThreshold; }
+
+		/**
+		Returns the current value of the <b>DiscardThreshold</b> option.
+		*/
+		inline const Level& getDiscardThreshold() const
+			{ return *discardThreshold; }
+
+		/**
+		The <b>SummaryInterval</b> option takes the minimum number of
+		seconds between two "events discarded" summary events.
+		*/
+		inline void setSummaryInterval(long summaryInterval)
+			{ this->summaryInterval = summaryInterval; }
+
+		/**
+		Returns the current value of the <b>SummaryInterval</b> option.
+		*/
+		inline long getSummaryInterval() const
+			{ return summaryInterval; }
+
+		/**
+		Returns the number of events discarded since this appender
+		was created.
+		*/
+		inline long getDiscardedCount() const
+			{ return discardedCount; }
+
+	protected:
+		/**
+		Count a discarded event.
+		*/
+		void discard(const spi::LoggingEvent& event);
+
+		/**
+		Dispatch a summary event if events were discarded and the
+		summary interval has elapsed, or in any case if
+		<code>force</code> is <code>true</code>. Only called from the
+		dispatcher thread.
+		*/
+		void appendSummary(bool force);
+
+		volatile long discardedCount;
+		volatile long pendingDiscarded;
+		volatile long discardedMaxLevel;
+		time_t lastSummary;
+		LoggerPtr summaryLogger;
+
+		/** Producers waiting for free space in the helpers::BoundedFIFO,
+		guarded by the buffer lock. */
+		int producersWaiting;
+		helpers::Semaphore notFull;
+
+		/** Recycled copies of the events queued in the
+		helpers::BoundedFIFO, guarded by the buffer lock. */
+		helpers::LoggingEventPool pool;
+
+		/** Posted by the dispatcher when it has processed its last
+		event. */
+		helpers::Semaphore dispatcherEnded;
+
+		/**
+		Create the buffer and start the dispatcher thread.
+		The caller must hold the appender lock.
+		*/
+		void startDispatcher();
 	}; // class AsyncAppender
 
 	class Dispatcher : public  helpers::Thread
 	{
 		helpers::BoundedFIFOPtr bf;
-		bool interrupted;
+		helpers::RingBufferPtr rb;
+		volatile bool interrupted;
 		AsyncAppender * container;
 
+		/** The events taken from the buffer and being dispatched. */
+		spi::LoggingEventList batch;
+
+		/** The copies of the events taken from a helpers::RingBuffer,
+		as many as it holds, reused from one batch to the next. */
+		spi::LoggingEvent * copies;
+
 	public:
 		Dispatcher(helpers::BoundedFIFOPtr bf, AsyncAppender * container);
+		Dispatcher(helpers::RingBufferPtr rb, AsyncAppender * container);
+		~Dispatcher();
 		void close();
 
 		/**
 		The dispatching strategy is to wait until there are events in the
-		buffer to process. After having processed an event, we release
-		the monitor (variable bf) so that new events can be placed in the
-		buffer, instead of keeping the monitor and processing the remaining
-		events in the buffer.
-		<p>Other approaches might yield better results.
+		buffer to process. All the available events are then taken from
+		the buffer in one acquisition of the monitor (variable bf) and
+		handed to the attached appenders as one batch through
+		Appender#doAppendBatch, so that each appender takes its lock and
+		flushes its output once per batch instead of once per event.
+
+		<p>With a helpers::RingBuffer, each event is copied out of its
+		slot, which is released right away, so that the producers may
+		reuse or evict it while the batch is dispatched.
 		*/
 		void run();
+
+	protected:
+		void runRingBuffer();
 	}; // class Dispatcher
 }; //  namespace log4cxx
 
@@ -20,7 +20,9 @@
 #include <log4cxx/config.h>
 #include <log4cxx/helpers/tchar.h>
 #include <log4cxx/writerappender.h>
+#include <log4cxx/helpers/semaphore.h>
 #include <fstream>
+#include <vector>
 
 namespace log4cxx
 {
@@ -30,9 +32,45 @@ namespace log4cxx
 	*  <p>Support for <code>java.io.Writer</code> and console appending
 	*  has been deprecated and then removed. See the replacement
 	*  solutions: WriterAppender and ConsoleAppender.
+	*
+	*  <p>With the <b>BufferedIO</b> option, the events are written to a
+	*  buffer of <b>BufferSize</b> characters which goes to the file
+	*  when it is full, when an event of level <code>WARN</code> or
+	*  higher is appended, and at least every <b>FlushInterval</b>
+	*  milliseconds, by a background thread.
+	*
+	*  <p>With the <b>RawIO</b> option, available on POSIX systems in
+	*  ANSI builds, the file is written with system calls on a file
+	*  descriptor opened with <code>O_APPEND</code> rather than through
+	*  a stream, and the events of a batch (see
+	*  AppenderSkeleton#doAppendBatch) are written with one
+	*  <code>writev</code>. The <b>Sync</b> option then selects when
+	*  the data is forced to the disk with <code>fdatasync</code>:
+	*  never (<code>none</code>, the default), after each write
+	*  (<code>batch</code>) or every <b>FlushInterval</b>
+	*  (<code>interval</code>).
 	*/
  	class FileAppender : public WriterAppender
 	{
+	class Flusher;
+	friend class Flusher;
+
+	public:
+		/** The default flush interval is set to 1 second. */
+		static long DEFAULT_FLUSH_INTERVAL;
+
+		/** When the data written with <b>RawIO</b> is forced to the
+		disk. */
+		enum SyncPolicy
+		{
+			/** Leave it to the system. */
+			SYNC_NONE,
+			/** After each write system call, or batch of them. */
+			SYNC_BATCH,
+			/** Every <b>FlushInterval</b> milliseconds. */
+			SYNC_INTERVAL
+		};
+
 	protected:
 		/** Append to or truncate the file? The default value for this
 		variable is <code>true</code>, meaning that by default a
@@ -55,6 +93,57 @@ namespace log4cxx
 		How big should the IO buffer be? Default is 8K. */
 		int bufferSize;
 
+		/**
+		The buffer of the file, when bufferedIO is set. */
+		TCHAR * buffer;
+
+		/**
+		The maximum milliseconds an event remains in the buffer, 0 if
+		the buffer is only written when it is full. */
+		long flushInterval;
+
+		/**
+		Is there text in the buffer which was not flushed? */
+		bool dirty;
+
+		/**
+		Write the file with system calls rather than a stream? */
+		bool rawIO;
+
+		/**
+		See SyncPolicy. */
+		int syncPolicy;
+
+		/**
+		The file descriptor written with rawIO, -1 otherwise. */
+		int fd;
+
+		/**
+		The length of the file written with rawIO. */
+		long fileLength;
+
+		/**
+		The characters in the buffer, with rawIO. */
+		size_t pending;
+
+		/**
+		Was the file written since the last sync? */
+		bool unsynced;
+
+		/**
+		The text of the event being written, kept between events. */
+		tstring text;
+
+		/**
+		The texts of the events of a batch, kept between batches. */
+		std::vector<tstring> batchText;
+
+		/**
+		The thread flushing the buffer every flushInterval. */
+		Flusher * flusher;
+		helpers::Semaphore flusherStop;
+		helpers::Semaphore flusherEnded;
+
 #ifdef UNICODE
 		std::wofstream ofs;
 #else
@@ -134,12 +223,68 @@ namespace log4cxx
 		void setOption(const std::string& option,
 			const std::string& value);
 
+		/**
+		Stop the flusher, then close the file.
+		*/
+		void close();
+
 	protected:
         /**
         Closes the previously opened file.
         */
         virtual void closeWriter();
 
+		/**
+		Open the file, in append mode if <code>append</code> is true
+		and truncation mode otherwise. Returns <code>false</code> if
+		the file could not be opened.
+		*/
+		virtual bool openFile(bool append);
+
+		/**
+		Flush and close the file.
+		*/
+		virtual void closeFile();
+
+		/**
+		Returns the length of the file.
+		*/
+		virtual long getFileLength();
+
+		/**
+		With rawIO, write all the events of the batch with one system
+		call, otherwise see WriterAppender#appendBatch.
+		*/
+		void appendBatch(const spi::LoggingEventList& events);
+
+		void writeHeader();
+		void writeFooter();
+
+		/**
+		Write the event, and flush the buffer if the event is a
+		<code>WARN</code> or more severe.
+		*/
+		void subAppend(const spi::LoggingEvent& event);
+		void subAppend(const spi::LoggingEvent& event,
+			const tstring& formatted);
+
+		/**
+		Flush the buffer if some text was not flushed, called by the
+		flusher.
+		*/
+		void flushBuffer();
+
+		/** Write the buffer and the event to the file. */
+		void flushFile();
+
+		/** The rawIO counterparts of the stream operations. */
+		void writeRaw(const TCHAR * text, size_t length);
+		void flushRaw();
+		void syncRaw();
+
+		void startFlusher();
+		void stopFlusher();
+
     public:
         /**
         Get the value of the <b>BufferedIO</b> option.
@@ -182,6 +327,45 @@ namespace log4cxx
         Set the size of the IO buffer.
         */
         void setBufferSize(int bufferSize) { this->bufferSize = bufferSize; }
+
+        /**
+        Get the value of the <b>FlushInterval</b> option.
+        */
+        inline long getFlushInterval() const { return flushInterval; }
+
+        /**
+        The <b>FlushInterval</b> option takes the maximum number of
+        milliseconds an event remains in the buffer when
+        <b>BufferedIO</b> is set. With 0, the buffer is only written
+        when it is full or when a <code>WARN</code> event is appended.
+        <p>Note: The flusher is started by #activateOptions.
+        */
+        void setFlushInterval(long flushInterval)
+			{ this->flushInterval = flushInterval; }
+
+        /**
+        Get the value of the <b>RawIO</b> option.
+        */
+        inline bool getRawIO() const { return rawIO; }
+
+        /**
+        The <b>RawIO</b> option takes a boolean value. It is set to
+        <code>false</code> by default. If true, the file is written
+        with system calls on a file descriptor.
+        <p>Note: Actual opening of the file is made when 
+        #activateOptions is called, not when the options are set.
+        */
+        void setRawIO(bool rawIO) { this->rawIO = rawIO; }
+
+        /**
+        Get the value of the <b>Sync</b> option, see SyncPolicy.
+        */
+        inline int getSyncPolicy() const { return syncPolicy; }
+
+        /**
+        Set the value of the <b>Sync</b> option, see SyncPolicy.
+        */
+        void setSyncPolicy(int syncPolicy) { this->syncPolicy = syncPolicy; }
 			
 	}; // class FileAppender
 }; // namespace log4cxx
@@ -24,8 +24,8 @@ namespace log4cxx
 	namespace helpers
 	{
 		/**
-		Formats a date in the format "%H:%M:%S" for example,
-		"15:49:37".
+		Formats a date in the format "%H:%M:%S,SSS" for example,
+		"15:49:37,459".
 		*/
 		class AbsoluteTimeDateFormat : public DateFormat
 		{
@@ -51,7 +51,7 @@ namespace log4cxx
 			static tstring DATE_AND_TIME_DATE_FORMAT;
 
 			AbsoluteTimeDateFormat(const tstring& timeZone = _T(""))
-			: DateFormat(_T("%H:%M:%S"), timeZone) {}
+			: DateFormat(_T("%H:%M:%S,SSS"), timeZone) {}
 		};
 	}; // namespace helpers
 }; // namespace log4cxx
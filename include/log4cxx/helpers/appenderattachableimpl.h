@@ -19,6 +19,7 @@
 #define _LOG4CXX_HELPERS_APPENDER_ATTACHABLE_IMPL_H
 
 #include <log4cxx/spi/appenderattachable.h>
+#include <log4cxx/helpers/hazardpointer.h>
 #include <vector>
 
 namespace log4cxx
@@ -26,17 +27,44 @@ namespace log4cxx
     namespace spi
     {
         class LoggingEvent;
+        typedef std::vector<const LoggingEvent *> LoggingEventList;
     }
     
     namespace helpers
     {
+        /**
+        Default implementation of the AppenderAttachable interface.
+
+        <p>The attached appenders are kept in an immutable array which is
+        replaced as a whole each time an appender is added or removed.
+        The logging path iterates over the current array without taking
+        the lock, so that a slow appender does not block the other
+        threads or the configuration changes.
+        */
         class AppenderAttachableImpl : public spi::AppenderAttachable
         {
         protected:
-            /** Array of appenders. */
-            AppenderList  appenderList;
+            /** Immutable array of appenders, defined in the implementation
+            file. */
+            struct AppenderArray;
+
+            /** Current array of appenders, <code>0</code> when no appender
+            is attached. Only replaced while holding the lock, read under
+            a HazardPointer. */
+            AppenderArray * volatile appenders;
+
+            /** The arrays replaced while a thread could still read them,
+            deleted as soon as no thread protects them. */
+            RetiredList<AppenderArray> retiredAppenders;
+
+            /** Publish <code>newAppenders</code> and retire the previous
+            array. Must be called while holding the lock. */
+            void replaceAppenders(AppenderArray * newAppenders);
 
         public:
+            AppenderAttachableImpl();
+            ~AppenderAttachableImpl();
+
           // Methods
             /**
              * Add an appender.
@@ -48,6 +76,12 @@ namespace log4cxx
             */
             int appendLoopOnAppenders(const spi::LoggingEvent& event);
 
+            /**
+             Call the <code>doAppendBatch</code> method on all attached
+             appenders.
+            */
+            int appendLoopOnAppenders(const spi::LoggingEventList& events);
+
             /**
              * Get all previously added appenders as an Enumeration.
              */
@@ -0,0 +1,263 @@
+/***************************************************************************
+                          atomic.h  -  class Atomic
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_HELPERS_ATOMIC_H
+#define _LOG4CXX_HELPERS_ATOMIC_H
+
+#include <log4cxx/config.h>
+
+#ifdef WIN32
+#include <windows.h>
+#elif !defined(__GNUC__) && defined(HAVE_PTHREAD_H)
+#define LOG4CXX_ATOMIC_LOCKED
+#include <log4cxx/helpers/criticalsection.h>
+#endif
+
+#ifdef LOG4CXX_ATOMIC_LOCKED
+#define LOG4CXX_ATOMIC_GUARD Atomic::Guard guard;
+#else
+#define LOG4CXX_ATOMIC_GUARD
+#endif
+
+namespace log4cxx
+{
+	namespace helpers
+	{
+		/**
+		Atomic operations on integers and pointers shared between threads.
+
+		<p>Reads have acquire semantics, writes have release semantics and
+		read-modify-write operations are full memory barriers.
+		Other compilers with pthreads serialize the operations with one
+		critical section, builds without threads use plain accesses.
+		*/
+		class Atomic
+		{
+		/** Atomic is a static class. */
+		private:
+			Atomic() {}
+
+#ifdef LOG4CXX_ATOMIC_LOCKED
+			/** The critical section of all the operations. */
+			static CriticalSection& getLock();
+
+			/** Creates the critical section before any thread starts. */
+			static CriticalSection& initialLock;
+
+			/** Holds the critical section of the operations for its
+			lifetime. */
+			class Guard
+			{
+			public:
+				Guard() { getLock().lock(); }
+				~Guard() { getLock().unlock(); }
+			};
+
+			friend class Guard;
+#endif
+
+		public:
+			/** Returns the value of <code>*value</code>. */
+			static inline long get(const volatile long * value)
+			{
+#ifdef WIN32
+				long r = *value;
+				::MemoryBarrier();
+				return r;
+#elif defined(__GNUC__)
+				return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				return *value;
+#endif
+			}
+
+			/** Sets <code>*value</code> to <code>newValue</code>. */
+			static inline void set(volatile long * value, long newValue)
+			{
+#ifdef WIN32
+				::MemoryBarrier();
+				*value = newValue;
+#elif defined(__GNUC__)
+				__atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				*value = newValue;
+#endif
+			}
+
+			/** Increments <code>*value</code> and returns the new value. */
+			static inline long increment(volatile long * value)
+			{
+#ifdef WIN32
+				return ::InterlockedIncrement(value);
+#elif defined(__GNUC__)
+				return __sync_add_and_fetch(value, 1);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				return ++*value;
+#endif
+			}
+
+			/** Decrements <code>*value</code> and returns the new value. */
+			static inline long decrement(volatile long * value)
+			{
+#ifdef WIN32
+				return ::InterlockedDecrement(value);
+#elif defined(__GNUC__)
+				return __sync_sub_and_fetch(value, 1);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				return --*value;
+#endif
+			}
+
+			/** Adds <code>delta</code> to <code>*value</code> and returns
+			the new value. */
+			static inline long add(volatile long * value, long delta)
+			{
+#ifdef WIN32
+				return ::InterlockedExchangeAdd(value, delta) + delta;
+#elif defined(__GNUC__)
+				return __sync_add_and_fetch(value, delta);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				return *value += delta;
+#endif
+			}
+
+			/** Sets <code>*value</code> to <code>newValue</code> and returns
+			the previous value. */
+			static inline long exchange(volatile long * value, long newValue)
+			{
+#ifdef WIN32
+				return ::InterlockedExchange(value, newValue);
+#elif defined(__GNUC__)
+				return __atomic_exchange_n(value, newValue, __ATOMIC_SEQ_CST);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				long r = *value;
+				*value = newValue;
+				return r;
+#endif
+			}
+
+			/** Sets <code>*value</code> to <code>newValue</code> if it is
+			equal to <code>expected</code>. Returns <code>true</code> if
+			the value was set. */
+			static inline bool compareAndSet(volatile long * value,
+				long expected, long newValue)
+			{
+#ifdef WIN32
+				return ::InterlockedCompareExchange(
+					value, newValue, expected) == expected;
+#elif defined(__GNUC__)
+				return __sync_bool_compare_and_swap(value, expected, newValue);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				if (*value != expected)
+				{
+					return false;
+				}
+				*value = newValue;
+				return true;
+#endif
+			}
+
+			/** Returns the pointer stored in <code>*p</code>. */
+			static inline void * getPointer(void * const volatile * p)
+			{
+#ifdef WIN32
+				void * r = *p;
+				::MemoryBarrier();
+				return r;
+#elif defined(__GNUC__)
+				return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				return *p;
+#endif
+			}
+
+			/** Stores <code>newValue</code> in <code>*p</code>. */
+			static inline void setPointer(void * volatile * p, void * newValue)
+			{
+#ifdef WIN32
+				::MemoryBarrier();
+				*p = newValue;
+#elif defined(__GNUC__)
+				__atomic_store_n(p, newValue, __ATOMIC_RELEASE);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				*p = newValue;
+#endif
+			}
+
+			/** Stores <code>newValue</code> in <code>*p</code> and returns
+			the previous pointer. */
+			static inline void * exchangePointer(void * volatile * p,
+				void * newValue)
+			{
+#ifdef WIN32
+				return ::InterlockedExchangePointer(p, newValue);
+#elif defined(__GNUC__)
+				return __atomic_exchange_n(p, newValue, __ATOMIC_SEQ_CST);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				void * r = *p;
+				*p = newValue;
+				return r;
+#endif
+			}
+
+			/** Stores <code>newValue</code> in <code>*p</code> if it is
+			equal to <code>expected</code>. Returns <code>true</code> if
+			the pointer was stored. */
+			static inline bool compareAndSetPointer(void * volatile * p,
+				void * expected, void * newValue)
+			{
+#ifdef WIN32
+				return ::InterlockedCompareExchangePointer(
+					p, newValue, expected) == expected;
+#elif defined(__GNUC__)
+				return __sync_bool_compare_and_swap(p, expected, newValue);
+#else
+				LOG4CXX_ATOMIC_GUARD
+				if (*p != expected)
+				{
+					return false;
+				}
+				*p = newValue;
+				return true;
+#endif
+			}
+
+			/** Full memory barrier. */
+			static inline void memoryBarrier()
+			{
+#ifdef WIN32
+				::MemoryBarrier();
+#elif defined(__GNUC__)
+				__sync_synchronize();
+#else
+				LOG4CXX_ATOMIC_GUARD
+#endif
+			}
+		}; // class Atomic
+	}; // namespace helpers
+}; // namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_ATOMIC_H
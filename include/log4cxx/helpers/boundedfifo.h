@@ -49,6 +49,7 @@ namespace log4cxx
 			Instantiate a new BoundedFIFO with a maximum size passed as argument.
 			*/
 			BoundedFIFO(int maxSize);
+			~BoundedFIFO();
 
 			/**
 			Get the first element in the buffer. Returns <code>null</code> if
@@ -87,7 +88,9 @@ namespace log4cxx
 
 			/**
 			Resize the buffer to a new size. If the new size is smaller than
-			the old size events might be lost.
+			the old size events might be lost, the events which do not fit
+			are deleted. As for #get and #put, the caller must hold the lock
+			of the buffer.
 			*/
 			void resize(int newSize);
 			
@@ -0,0 +1,62 @@
+/***************************************************************************
+                          clock.h  -  class Clock
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_HELPERS_CLOCK_H
+#define _LOG4CXX_HELPERS_CLOCK_H
+
+#include <log4cxx/config.h>
+#include <time.h>
+
+namespace log4cxx
+{
+	namespace helpers
+	{
+		/**
+		High resolution clock used to time stamp the logging events.
+
+		<p>Where a monotonic clock is available, the time is read from it
+		and anchored to the wall clock time when the clock is first used.
+		The time stamps of successive events can then never go backwards,
+		even if the system time is stepped.
+		*/
+		class Clock
+		{
+		/** Clock is a static class. */
+		private:
+			Clock() {}
+
+		public:
+			/**
+			Get the current time, in seconds elapsed since 01.01.1970
+			and microseconds elapsed in that second.
+			*/
+			static void getTime(time_t& seconds, long& microseconds);
+
+		private:
+			/** Compute the offset between the monotonic clock and the
+			wall clock. Returns <code>false</code> if another thread is
+			computing it. */
+			static bool anchor();
+
+			/** 0 until anchored, 2 while anchoring, 1 once anchored. */
+			static volatile long anchored;
+			static time_t offsetSeconds;
+			static long offsetMicroseconds;
+		}; // class Clock
+	}; // namespace helpers
+}; // namespace log4cxx
+
+#endif // _LOG4CXX_HELPERS_CLOCK_H
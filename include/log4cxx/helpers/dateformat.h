@@ -19,20 +19,82 @@
 
 #include <log4cxx/helpers/tchar.h>
 #include <locale>
+#include <time.h>
 
 namespace log4cxx
 {
 	namespace helpers
 	{
+		/**
+		Formats a date with a <code>strftime</code> like format.
+
+		<p>In addition to the <code>strftime</code> conversions, the
+		first run of <b>SSS</b> in the format is replaced by the
+		milliseconds and the first run of <b>SSSSSS</b> by the
+		microseconds of the date, for example
+		<code>"%H:%M:%S,SSS"</code>.
+
+		<p>Consecutive events are usually logged in the same second, so
+		the text of the last formatted second is cached by each
+		DateFormat. The cache is guarded by a sequence counter: readers
+		never wait, and only one thread at a time may replace its
+		content.
+		*/
 		class DateFormat
 		{
 		public:
 			DateFormat(const tstring& dateFormat, const tstring& timeZone = _T(""));
-			virtual void format(tostream& os, time_t time);
+			virtual ~DateFormat() {}
+
+			/**
+			Writes the date <code>time</code> seconds and
+			<code>microseconds</code> after 01.01.1970 formatted to
+			<code>os</code>.
+			*/
+			virtual void format(tostream& os, time_t time,
+				long microseconds = 0);
+
+			/**
+			Appends the date <code>time</code> seconds and
+			<code>microseconds</code> after 01.01.1970 formatted to
+			<code>output</code>.
+			*/
+			virtual void format(tstring& output, time_t time,
+				long microseconds = 0);
 
 		protected:
+			/**
+			Appends <code>time</code> formatted with the
+			<code>strftime</code> like <code>format</code> to
+			<code>output</code>.
+			*/
+			void formatTime(tstring& output, const struct tm& tm,
+				const tstring& format);
+
 			tstring timeZone;
 			tstring dateFormat;
+
+			/** Locale named by the timeZone option, created once. */
+			std::locale locale;
+
+			/** The parts of dateFormat before and after the fraction
+			of second. */
+			tstring prefixFormat;
+			tstring suffixFormat;
+
+			/** Number of digits of the fraction of second, 0, 3 or 6. */
+			int fractionDigits;
+
+		private:
+			enum { CACHE_SIZE = 64 };
+
+			/** Odd while the cache is being written. */
+			volatile long cacheSequence;
+			time_t cachedTime;
+			int cachedLength;
+			/** Length of the prefix in cachedText. */
+			int cachedSplit;
+			TCHAR cachedText[CACHE_SIZE];
 		};
 	}; // namespace helpers
 }; // namespace log4cxx
@@ -24,14 +24,14 @@ namespace log4cxx
 	namespace helpers
 	{
 		/**
-		Formats a date in the format "\%d \%b \%Y \%H:\%M:\%S" for example,
-	   "06 Nov 1994 15:49:37".
+		Formats a date in the format "\%d \%b \%Y \%H:\%M:\%S,SSS" for
+		example, "06 Nov 1994 15:49:37,459".
 		*/
 		class DateTimeDateFormat : public DateFormat
 		{
 		public:
 			DateTimeDateFormat(const tstring& timeZone = _T(""))
-			 : DateFormat(_T("%d %b %Y %H:%M:%S"), timeZone) {}
+			 : DateFormat(_T("%d %b %Y %H:%M:%S,SSS"), timeZone) {}
 		};
 	}; // namespace helpers
 }; // namespace log4cxx
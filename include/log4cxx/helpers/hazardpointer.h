@@ -0,0 +1,162 @@
+/***************************************************************************
+                          hazardpointer.h  -  class HazardPointer
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_HELPERS_HAZARD_POINTER_H
+#define _LOG4CXX_HELPERS_HAZARD_POINTER_H
+
+#include <log4cxx/config.h>
+#include <log4cxx/helpers/criticalsection.h>
+#include <vector>
+
+namespace log4cxx
+{
+	namespace helpers
+	{
+		/**
+		<code>HazardPointer</code> protects an object shared through an
+		atomic pointer while a thread reads it without locking.
+
+		<p>The reader declares a HazardPointer on the shared pointer
+		for the time it uses the object. The writer replaces the shared
+		pointer, then only deletes the previous object once
+		#isProtected returns false for it, and keeps it retired
+		otherwise. A reader does not write any memory shared with the
+		other threads, each thread owns a record of a few slots which
+		are reused by the threads started later.
+
+		<p>The slots of a thread are used as a stack, so that a thread
+		may protect several objects at once, for instance while an
+		appender logs an event itself. Beyond the slots of its record,
+		a thread prevents the deletion of all the retired objects until
+		it releases its pointer.
+		*/
+		class HazardPointer
+		{
+		public:
+			/**
+			Protect the object <code>*source</code> points to.
+			*/
+			HazardPointer(void * const volatile * source);
+
+			/**
+			Release the protection of the object.
+			*/
+			~HazardPointer();
+
+			/**
+			Returns the protected object, which can be used until this
+			HazardPointer is destroyed.
+			*/
+			inline void * get() const
+				{ return pointer; }
+
+			/**
+			Returns true if a thread protects <code>pointer</code>. The
+			object must have been replaced in its shared pointer before.
+			*/
+			static bool isProtected(void * pointer);
+
+			/** The slots of a thread, defined in the implementation
+			file. */
+			struct Record;
+
+		protected:
+			Record * record;
+			int slot;
+			void * pointer;
+
+		private:
+			HazardPointer(const HazardPointer&);
+			HazardPointer& operator=(const HazardPointer&);
+		}; // class HazardPointer
+
+		/**
+		<code>RetiredList</code> keeps the objects replaced in a pointer
+		read through HazardPointer, and deletes each one once no thread
+		protects it any more.
+
+		<p>The writers may retire objects concurrently. The objects
+		still retired are deleted with the list, when no reader may
+		remain.
+		*/
+		template<class T> class RetiredList
+		{
+		public:
+			RetiredList()
+			{
+			}
+
+			~RetiredList()
+			{
+				typename std::vector<T *>::iterator it, itEnd = objects.end();
+				for (it = objects.begin(); it != itEnd; it++)
+				{
+					delete *it;
+				}
+			}
+
+			/**
+			Retire <code>object</code>, which must have been replaced
+			in its shared pointer, then delete the retired objects no
+			thread protects. <code>0</code> is ignored.
+			*/
+			void retire(T * object)
+			{
+				cs.lock();
+
+				if (object != 0)
+				{
+					objects.push_back(object);
+				}
+
+				typename std::vector<T *>::iterator it = objects.begin();
+				while (it != objects.end())
+				{
+					if (HazardPointer::isProtected(*it))
+					{
+						it++;
+					}
+					else
+					{
+						delete *it;
+						it = objects.erase(it);
+					}
+				}
+
+				cs.unlock();
+			}
+
+			/** Number of the objects still retired. */
+			int size()
+			{
+				cs.lock();
+				int n = (int)objects.size();
+				cs.unlock();
+				return n;
+			}
+
+		protected:
+			CriticalSection cs;
+			std::vector<T *> objects;
+
+		private:
+			RetiredList(const RetiredList&);
+			RetiredList& operator=(const RetiredList&);
+		}; // class RetiredList
+	}; // namespace helpers
+}; // namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_HAZARD_POINTER_H
@@ -0,0 +1,83 @@
+/***************************************************************************
+                          loggingeventpool.h  -  class LoggingEventPool
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_HELPERS_LOGGING_EVENT_POOL_H
+#define _LOG4CXX_HELPERS_LOGGING_EVENT_POOL_H
+
+#include <log4cxx/config.h>
+#include <vector>
+
+namespace log4cxx
+{
+	namespace spi
+	{
+		class LoggingEvent;
+	};
+
+	namespace helpers
+	{
+		/**
+		<code>LoggingEventPool</code> recycles the copies of the logging
+		events queued by the AsyncAppender.
+
+		<p>A released event is kept with its message and NDC storage, so
+		that copying the next event into it does not allocate memory as
+		long as the new strings fit in the old capacity. The pool grows
+		when all its events are in use.
+
+		<p>The pool is not synchronized, the caller must hold a lock.
+		*/
+		class LoggingEventPool
+		{
+		public:
+			LoggingEventPool();
+			~LoggingEventPool();
+
+			/**
+			Make sure that at least <code>size</code> free events are
+			allocated.
+			*/
+			void reserve(int size);
+
+			/**
+			Get a free event holding a copy of <code>event</code>.
+			*/
+			spi::LoggingEvent * acquire(const spi::LoggingEvent& event);
+
+			/**
+			Give back an event obtained with #acquire. The pool owns
+			the event again, whatever the constness of the pointer it
+			was dispatched with.
+			*/
+			void release(const spi::LoggingEvent * event);
+
+			/**
+			Delete the free events beyond the first <code>size</code>
+			ones.
+			*/
+			void trim(int size);
+
+		protected:
+			std::vector<spi::LoggingEvent *> freeEvents;
+
+		private:
+			LoggingEventPool(const LoggingEventPool&);
+			LoggingEventPool& operator=(const LoggingEventPool&);
+		}; // class LoggingEventPool
+	}; // namespace helpers
+}; // namespace log4cxx
+
+#endif // _LOG4CXX_HELPERS_LOGGING_EVENT_POOL_H
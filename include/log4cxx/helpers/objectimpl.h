@@ -26,7 +26,12 @@ namespace log4cxx
 {
 	namespace helpers
 	{
-		/** Implementation class for Object.*/
+		/** Implementation class for Object.
+
+		<p>The reference count is updated with atomic operations, see
+		helpers::Atomic, so that copying an ObjectPtr takes no lock with
+		the compilers Atomic supports natively.
+		*/
 		class ObjectImpl : public virtual Object
 		{
 		public:
@@ -40,10 +45,7 @@ namespace log4cxx
 			virtual void notify();
 
 		protected:
-			unsigned int ref;
-#ifdef HAVE_PTHREAD_H
-			CriticalSection refCs;
-#endif
+			volatile long ref;
 			CriticalSection cs;
 			Semaphore sem;
 		};
@@ -21,7 +21,14 @@ namespace log4cxx
 {
     namespace helpers
     {
-		/** smart pointer to a Object descendant */
+		/** smart pointer to a Object descendant
+
+		<p>Each copy of an ObjectPtr increments the reference count of
+		the pointed object. Where no ownership is needed, borrow the
+		pointer instead: pass a <code>const ObjectPtr&</code> or use the
+		raw pointer returned by #get while a reference is held elsewhere.
+		To hand over a reference without touching the count, use #swap.
+		*/
         template<class T> class ObjectPtr
         {
         public:
@@ -98,6 +105,21 @@ namespace log4cxx
             T& operator*() const {return *p; }
             operator T*() const {return p; }
 
+            /** Borrow the pointer. The reference count is not
+            incremented, so the result is only valid as long as a
+            reference is held elsewhere. */
+            T* get() const {return p; }
+
+            /** Exchange the pointers held by this and <code>p</code>.
+            The reference counts are not touched, which moves a
+            reference from one ObjectPtr to another one at no cost. */
+            void swap(ObjectPtr& p)
+            {
+                T * tmp = this->p;
+                this->p = p.p;
+                p.p = tmp;
+            }
+
         public:
             T * p;
         };
@@ -31,10 +31,31 @@ namespace log4cxx
 	namespace helpers
 	{
 		class FormattingInfo;
+		class DateFormat;
 
 		class PatternConverter;
 		typedef ObjectPtr<PatternConverter> PatternConverterPtr;
 
+		/**
+		Instruction of a pattern compiled by the PatternLayout.
+		*/
+		struct PatternInstruction
+		{
+			int opcode;
+			int min;
+			int max;
+			bool leftAlign;
+			/** Precision of the logger name, or identifier of the MDC
+			key. */
+			int option;
+			/** Text of a literal instruction. */
+			tstring literal;
+			/** Formatter of a date instruction. */
+			DateFormat * dateFormat;
+			/** Converter called by a generic instruction. */
+			PatternConverter * converter;
+		};
+
 		/**
 		<p>PatternConverter is an abtract class that provides the
 		formatting functionality that derived classes need.
@@ -46,6 +67,25 @@ namespace log4cxx
 		class PatternConverter : public ObjectImpl
 		{
 		public:
+			/** Instruction codes of a compiled pattern. */
+			enum Opcode
+			{
+				GENERIC_OP,
+				LITERAL_OP,
+				MESSAGE_OP,
+				DATE_OP,
+				LEVEL_OP,
+				LOGGER_OP,
+				THREAD_OP,
+				RELATIVE_TIME_OP,
+				NDC_OP,
+				FULL_LOCATION_OP,
+				FILE_OP,
+				LINE_OP,
+				MDC_OP,
+				METHOD_OP
+			};
+
 			PatternConverterPtr next;
 			int min;
 			int max;
@@ -74,6 +114,13 @@ namespace log4cxx
 			*/
 			void spacePad(tostream& sbuf, int length);
 
+			/**
+			Describe this converter as an instruction of a compiled
+			pattern. The default implementation compiles to a generic
+			instruction, which calls #format on this converter.
+			*/
+			virtual void compile(PatternInstruction& instruction);
+
 		}; // class PatternConverter
 	}; // namespace helpers
 }; // namespace log4cxx
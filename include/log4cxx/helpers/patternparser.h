@@ -87,6 +87,7 @@ namespace log4cxx
 			public:
 				BasicPatternConverter(const FormattingInfo& formattingInfo, int type);
 				virtual void convert(tostream& sbuf, const spi::LoggingEvent& event);
+				virtual void compile(PatternInstruction& instruction);
 			};
 
 			class LiteralPatternConverter : public PatternConverter
@@ -98,6 +99,7 @@ namespace log4cxx
 				LiteralPatternConverter(const tstring& value);
 				virtual void format(tostringstream& sbuf, const spi::LoggingEvent& e);
 				virtual void convert(tostream& sbuf, const spi::LoggingEvent& event);
+				virtual void compile(PatternInstruction& instruction);
 			};
 
 			class DatePatternConverter : public PatternConverter
@@ -111,16 +113,20 @@ namespace log4cxx
 				
 			public:
 				virtual void convert(tostream& sbuf, const spi::LoggingEvent& event);
+				virtual void compile(PatternInstruction& instruction);
 			};
 
 			class MDCPatternConverter : public PatternConverter
 			{
 			private:
 				tstring key;
+				/** Identifier of the key, see MDC#getKeyId. */
+				int keyId;
 			
 			public:
 				MDCPatternConverter(const FormattingInfo& formattingInfo, const tstring& key);
 				virtual void convert(tostream& sbuf, const spi::LoggingEvent& event);
+				virtual void compile(PatternInstruction& instruction);
 			};
 
 			class LocationPatternConverter : public PatternConverter
@@ -131,6 +137,7 @@ namespace log4cxx
 			public:
 				LocationPatternConverter(const FormattingInfo& formattingInfo, int type);
 				virtual void convert(tostream& sbuf, const spi::LoggingEvent& event);
+				virtual void compile(PatternInstruction& instruction);
 			};
 
 			class CategoryPatternConverter : public PatternConverter
@@ -141,6 +148,7 @@ namespace log4cxx
 			public:
 				CategoryPatternConverter(const FormattingInfo& formattingInfo, int precision);
 				virtual void convert(tostream& sbuf, const spi::LoggingEvent& event);
+				virtual void compile(PatternInstruction& instruction);
 			};
 		}; // class PatternParser
 	}; // namespace helpers
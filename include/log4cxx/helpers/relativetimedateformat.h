@@ -24,7 +24,7 @@ namespace log4cxx
 	namespace helpers
 	{
 		/**
-		Formats a date by printing the number of seconds
+		Formats a date by printing the number of milliseconds
 		elapsed since the start of the application. This is the fastest
 		printing DateFormat in the package.
 		*/
@@ -32,16 +32,25 @@ namespace log4cxx
 		{
 		protected:
 			time_t startTime;
-			
+			long startMicroseconds;
+
 		public:
-			RelativeTimeDateFormat() : DateFormat(_T(""), _T("")), startTime(time(0))
-			{
-			}
-			
-			virtual void format(tostream& os, time_t time)
-			{
-				os << (time - startTime);
-			}
+			RelativeTimeDateFormat();
+
+			virtual void format(tostream& os, time_t time,
+				long microseconds = 0);
+
+			virtual void format(tstring& output, time_t time,
+				long microseconds = 0);
+
+			/**
+			Appends the number of milliseconds elapsed between the start
+			date and the date <code>time</code>, <code>microseconds</code>
+			to <code>output</code>.
+			*/
+			static void appendElapsed(tstring& output,
+				time_t startTime, long startMicroseconds,
+				time_t time, long microseconds);
 		};
 	}; // namespace helpers
 }; // namespace log4cxx
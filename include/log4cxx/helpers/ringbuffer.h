@@ -0,0 +1,155 @@
+/***************************************************************************
+                          ringbuffer.h  -  RingBuffer
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+* Copyright (C) The Apache Software Foundation. All rights reserved.      *
+*                                                                         *
+* This software is published under the terms of the Apache Software       *
+* License version 1.1, a copy of which has been included with this        *
+* distribution in the LICENSE.txt file.                                   *
+***************************************************************************/
+
+#ifndef _LOG4CXX_HELPERS_RING_BUFFER_H
+#define _LOG4CXX_HELPERS_RING_BUFFER_H
+
+#include <log4cxx/helpers/objectimpl.h>
+#include <log4cxx/helpers/objectptr.h>
+#include <log4cxx/helpers/semaphore.h>
+
+namespace log4cxx
+{
+	namespace spi
+	{
+		class LoggingEvent;
+	};
+
+	namespace helpers
+	{
+		class RingBuffer;
+		typedef ObjectPtr<RingBuffer> RingBufferPtr;
+
+		/**
+		<code>RingBuffer</code> is a bounded, lock-free
+		multi-producer/single-consumer alternative to BoundedFIFO,
+		used by the AsyncAppender.
+
+		<p>All the event slots are allocated when the buffer is created.
+		Producers copy the event into a free slot in place, so that the
+		message and NDC storage of a slot is reused from one event to the
+		next. The consumer copies the event out of its slot and then
+		releases the slot back to the producers.
+
+		<p>Producers never take a lock: a slot is claimed with a single
+		compare-and-set on the tail position. The semaphores are only
+		used when the consumer waits for events or when a producer waits
+		for free space.
+		*/
+		class RingBuffer : public ObjectImpl
+		{
+		public:
+			/**
+			Instantiate a new RingBuffer holding at least
+			<code>capacity</code> events. The capacity is rounded up to the
+			next power of two.
+			*/
+			RingBuffer(int capacity);
+			~RingBuffer();
+
+			/**
+			Copy <code>event</code> into a free slot. Returns
+			<code>false</code> without waiting if the buffer is full.
+			*/
+			bool offer(const spi::LoggingEvent& event);
+
+			/**
+			Copy <code>event</code> into a free slot, waiting for the
+			consumer to release a slot if the buffer is full.
+			*/
+			void put(const spi::LoggingEvent& event);
+
+			/**
+			Claim the oldest event in the buffer. Returns <code>0</code>
+			if the buffer is empty. The slot must be handed back with
+			#release once the event has been processed.
+
+			<p>Besides the consumer, a producer may claim an event to
+			evict it from a full buffer, see #evict.
+			*/
+			spi::LoggingEvent * get();
+
+			/**
+			Claim the oldest event to make room for the next one.
+			Returns <code>0</code> if the buffer is not full, or while
+			the slot the next event goes to is claimed by the consumer
+			or by another producer. The slot must be handed back with
+			#release.
+			*/
+			spi::LoggingEvent * evict();
+
+			/**
+			Release a slot previously claimed with #get.
+			*/
+			void release(const spi::LoggingEvent * event);
+
+			/**
+			Wait until the buffer holds an event or #wakeUp is called.
+			Only the consumer may call this method.
+			*/
+			void await();
+
+			/**
+			Wake up the consumer if it is waiting in #await.
+			*/
+			void wakeUp();
+
+			/**
+			Returns <code>true</code> if there is no event to consume.
+			*/
+			bool isEmpty() const;
+
+			/**
+			Get the number of events in the buffer. The value is only
+			a snapshot when producers are running.
+			*/
+			int length() const;
+
+			/**
+			Get the maximum number of events in the buffer.
+			*/
+			inline int getMaxSize() const
+				{ return capacity; }
+
+		protected:
+			/** Signal the consumer after an event has been published. */
+			void signalConsumer();
+
+			int capacity;
+			long mask;
+			spi::LoggingEvent * events;
+
+			/** Sequence number of each slot. A slot is free for the
+			producer at position <code>pos</code> when its sequence is
+			<code>pos</code>, and ready for the consumer when its sequence
+			is <code>pos + 1</code>. */
+			volatile long * sequences;
+
+			// keep producer and consumer positions on separate cache lines
+			char pad0[64];
+			volatile long tail;
+			char pad1[64];
+			volatile long head;
+			char pad2[64];
+
+			volatile long consumerWaiting;
+			volatile long producersWaiting;
+			Semaphore notFull;
+		}; // class RingBuffer
+	}; // namespace helpers
+}; // namespace log4cxx
+
+#endif // _LOG4CXX_HELPERS_RING_BUFFER_H
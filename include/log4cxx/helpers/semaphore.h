@@ -41,6 +41,10 @@ namespace log4cxx
 			~Semaphore();
 			void wait();
 			bool tryWait();
+
+			/** Wait at most <code>millis</code> milliseconds, returns
+			<code>false</code> on timeout. */
+			bool tryWait(long millis);
 			void post();
 
 		protected:
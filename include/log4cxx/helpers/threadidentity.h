@@ -0,0 +1,95 @@
+/***************************************************************************
+                          threadidentity.h  -  class ThreadIdentity
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_HELPERS_THREAD_IDENTITY_H
+#define _LOG4CXX_HELPERS_THREAD_IDENTITY_H
+
+#include <log4cxx/helpers/tchar.h>
+#include <log4cxx/helpers/objectptr.h>
+#include <log4cxx/helpers/threadspecificdata.h>
+
+namespace log4cxx
+{
+	namespace helpers
+	{
+		class ThreadIdentity;
+		typedef ObjectPtr<ThreadIdentity> ThreadIdentityPtr;
+
+		/**
+		Identity of a thread as printed in the logs: a short number
+		given to each thread the first time it logs, an optional name,
+		and the text printed by the layouts, which is the name if it is
+		set and the number otherwise.
+
+		<p>Identities are immutable and reference counted, so that a
+		logging event can keep the identity of its thread after the
+		thread renamed itself or exited. Renaming a thread registers a
+		new identity with the same number.
+		*/
+		class ThreadIdentity
+		{
+		public:
+			/**
+			Create an identity which is not registered to any thread,
+			such as the identity of an event read from a socket.
+			*/
+			ThreadIdentity(unsigned long id, const tstring& name);
+
+			void addRef();
+			void releaseRef();
+
+			/** The number of the thread, starting at 1. */
+			inline unsigned long getId() const
+				{ return id; }
+
+			/** The name of the thread, empty if it was not set. */
+			inline const tstring& getName() const
+				{ return name; }
+
+			/** The text printed by the layouts. */
+			inline const tstring& getText() const
+				{ return text; }
+
+			/**
+			Returns the identity of the current thread, registering it
+			on first use. The identity is borrowed, it remains valid
+			until the current thread is renamed.
+			*/
+			static ThreadIdentity * getCurrent();
+
+			/**
+			Set the name of the current thread. An empty name reverts
+			to the number of the thread.
+			*/
+			static void setCurrentName(const tstring& name);
+
+		protected:
+			volatile long refCount;
+			unsigned long id;
+			tstring name;
+			tstring text;
+
+			static volatile long lastId;
+			static ThreadSpecificData threadSpecificData;
+
+		private:
+			ThreadIdentity(const ThreadIdentity&);
+			ThreadIdentity& operator=(const ThreadIdentity&);
+		}; // class ThreadIdentity
+	}; // namespace helpers
+}; // namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_THREAD_IDENTITY_H
@@ -26,6 +26,13 @@ namespace log4cxx
 		{
 		public:
 			ThreadSpecificData();
+
+			/**
+			<code>cleanup</code> is called with the data of a thread when
+			the thread exits, if the data is not null. It is not called
+			on Windows, where the data of a thread is not released.
+			*/
+			ThreadSpecificData(void (*cleanup)(void * data));
 			~ThreadSpecificData();
 			void * GetData() const;
 			void SetData(void * data);
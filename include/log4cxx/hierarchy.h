@@ -23,6 +23,7 @@
 #include <map>
 #include <log4cxx/provisionnode.h>
 #include <log4cxx/helpers/objectimpl.h>
+#include <log4cxx/helpers/hazardpointer.h>
 
 namespace log4cxx
 {
@@ -73,6 +74,9 @@ namespace log4cxx
 		
         int thresholdInt;
         const Level * threshold;
+
+        /** Incremented on each level, threshold or structure change. */
+        volatile long generation;
 		
         bool emittedNoAppenderWarning;
         bool emittedNoResourceBundleWarning;
@@ -81,6 +85,19 @@ namespace log4cxx
         Map synchronization
         */
         helpers::CriticalSection mapCs;
+
+        /**
+        Hash table of the loggers, read without any lock by #getLogger
+        and #exists under a HazardPointer. Loggers are only added to it,
+        under mapCs, and the loggers map stays the reference for the
+        hierarchy structure. When the table grows or is cleared, the
+        previous table is kept in retiredTables while readers may still
+        be walking it. A table replaced by #clear holds the loggers it
+        removed until it is deleted.
+        */
+        struct LoggerTable;
+        LoggerTable * volatile table;
+        helpers::RetiredList<LoggerTable> retiredTables;
 		
     public:
 		/**
@@ -146,6 +163,21 @@ namespace log4cxx
 		*/
 	public:
 		const Level& getThreshold();
+
+		/**
+		Returns the address of the generation counter, which is
+		incremented whenever a logger level, the threshold, the
+		hierarchy structure, the appenders or the additivity of a logger
+		changes.
+		*/
+	public:
+		volatile long * getGenerationCounter();
+
+		/**
+		Invalidate the effective level cached by the loggers.
+		*/
+	public:
+		void levelsChanged();
 		
 		/**
 		Return a new logger instance named as the first parameter using
@@ -279,6 +311,42 @@ namespace log4cxx
 	private:
 
 		void updateChildren(ProvisionNode& pn, LoggerPtr logger);
+
+		/**
+		Look up the logger named <code>name</code> in the hash table
+		without taking any lock. Returns <code>0</code> if the logger
+		is not found.
+		*/
+	private:
+		LoggerPtr findLogger(const tstring& name);
+
+		/**
+		Add <code>logger</code> to the hash table, growing it if
+		needed. Must be called under mapCs.
+		*/
+	private:
+		void publishLogger(const LoggerPtr& logger);
+
+		/**
+		Replace the hash table by <code>newTable</code>, then delete the
+		retired tables no reader walks any more. Must be called under
+		mapCs.
+		*/
+	private:
+		void replaceTable(LoggerTable * newTable);
+
+		/**
+		Copy the loggers of the map. Must be called under mapCs.
+		*/
+	private:
+		LoggerList copyLoggers();
+
+		/**
+		Close, then remove the appenders of the root logger and of
+		<code>loggers</code>.
+		*/
+	private:
+		void closeAppenders(const LoggerList& loggers);
 	};
 }; //namespace log4cxx
 
@@ -46,6 +46,18 @@ namespace log4cxx
 		*/
 		virtual void format(tostream& output, const spi::LoggingEvent& event) = 0;
 
+		/**
+		Append the formatted event to <code>output</code>. The base
+		class formats the event into a string stream, layouts can
+		override it to format directly into the string.
+		*/
+		virtual void format(tstring& output, const spi::LoggingEvent& event)
+		{
+			tostringstream oss;
+			format(oss, event);
+			output.append(oss.str());
+		}
+
 		/**
 		Returns the content type output by this layout. The base class
 		returns "text/plain".
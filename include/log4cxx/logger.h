@@ -24,6 +24,35 @@
 #include <log4cxx/spi/loggerrepository.h>
 #include <log4cxx/helpers/appenderattachableimpl.h>
 #include <log4cxx/helpers/objectimpl.h>
+#include <log4cxx/helpers/atomic.h>
+#include <log4cxx/helpers/hazardpointer.h>
+#include <log4cxx/level.h>
+#include <log4cxx/spi/callsite.h>
+
+/**
+Compile time minimum level of the LOG4CXX_* macros. The statements below
+this level are removed from the program. Define it, before including
+this file, to one of the LOG4CXX_LEVEL_* values, for example
+<code>-DLOG4CXX_MIN_LEVEL=LOG4CXX_LEVEL_INFO</code>.
+*/
+#define LOG4CXX_LEVEL_ALL 0
+#define LOG4CXX_LEVEL_DEBUG 10000
+#define LOG4CXX_LEVEL_INFO 20000
+#define LOG4CXX_LEVEL_WARN 30000
+#define LOG4CXX_LEVEL_ERROR 40000
+#define LOG4CXX_LEVEL_FATAL 50000
+
+#ifndef LOG4CXX_MIN_LEVEL
+#define LOG4CXX_MIN_LEVEL LOG4CXX_LEVEL_ALL
+#endif
+
+/** Branch prediction hint for the level checks of the statements which
+are usually disabled: DEBUG, INFO and WARN. */
+#if defined(__GNUC__)
+#define LOG4CXX_UNLIKELY(expr) __builtin_expect(!!(expr), 0)
+#else
+#define LOG4CXX_UNLIKELY(expr) (expr)
+#endif
 
 namespace log4cxx
 {
@@ -78,6 +107,52 @@ namespace log4cxx
         have their additivity flag set to <code>false</code> too. See
         the user manual for more details. */
         bool additive;
+
+        /**
+        The most restrictive of the effective level and of the
+        repository threshold, cached so that checking whether a level is
+        enabled does not walk the hierarchy. It is valid as long as
+        #cachedGeneration is equal to the generation counter of the
+        repository. */
+        int enabledLevel;
+
+        /** Generation of the repository when #enabledLevel was cached. */
+        volatile long cachedGeneration;
+
+        /** Generation counter of the repository. */
+        volatile long * generation;
+
+        /**
+        Compute #enabledLevel again.
+        */
+        void updateEnabledLevel();
+
+        /**
+        Flattened list of the appenders reachable from this logger
+        through additivity, defined in the implementation file.
+        */
+        struct Route;
+
+        /** Cached route of this logger, <code>0</code> until the first
+        event is logged. It is read without locking under a
+        helpers::HazardPointer. */
+        Route * volatile route;
+
+        /** The routes replaced while a thread could still read them,
+        deleted as soon as no thread protects them. */
+        helpers::RetiredList<Route> retiredRoutes;
+
+        /** Generation of the repository when #route was built. */
+        volatile long routeGeneration;
+
+        /** Generation of the appender thresholds when #route was
+        built. */
+        volatile long routeThresholdGeneration;
+
+        /**
+        Build the route of this logger again.
+        */
+        void updateRoute();
        
 	/**
         This constructor created a new <code>logger</code> instance and
@@ -104,6 +179,24 @@ namespace log4cxx
         */
   		virtual void addAppender(AppenderPtr newAppender);
 
+        /**
+        Remove all previously added appenders from this Logger
+        instance.
+        */
+        virtual void removeAllAppenders();
+
+        /**
+        Remove the appender passed as parameter from the list of
+        appenders.
+        */
+        virtual void removeAppender(AppenderPtr appender);
+
+        /**
+        Remove the appender with the name passed as parameter from the
+        list of appenders.
+        */
+        virtual void removeAppender(const tstring& name);
+
         /**
         If <code>assertion</code> parameter is <code>false</code>, then
 
@@ -130,6 +223,11 @@ namespace log4cxx
         hierarchy circumventing any evaluation of whether to log or not
         to log the particular log request.
 
+        <p>The appenders are called through the route cached by this
+        logger, which lists each reachable appender once. Appenders
+        whose threshold rejects the event are skipped without calling
+        their <code>doAppend</code> method.
+
         @param event the event to log.  */
         void callAppenders(const spi::LoggingEvent& event);
 
@@ -199,6 +297,19 @@ namespace log4cxx
         void forcedLog(const Level& level, const tstring& message, 
 			const char* file=0, int line=-1);
 
+        /**
+        This method creates a new logging event for the statement
+        described by <code>callSite</code> and logs the event without
+        further checks. It is called by the <code>LOG4CXX_*</code>
+        macros once they checked the level.
+        @param level the level to log.
+        @param message the message string to log.
+        @param callSite the static descriptor of the statement.
+        */
+    public:
+        void forcedLog(const Level& level, const tstring& message,
+			spi::CallSite& callSite);
+
 
         /**
         Get the additivity flag for this Logger instance.
@@ -332,7 +443,8 @@ namespace log4cxx
         *  enabled, <code>false</code> otherwise.
         *   */
     public:
-        bool isDebugEnabled();
+        inline bool isDebugEnabled()
+            { return isEnabledFor(Level::DEBUG_INT); }
 
         /**
         Check whether this logger is enabled for a given 
@@ -344,6 +456,25 @@ namespace log4cxx
         */
     public:
         bool isEnabledFor(const Level& level);
+
+        /**
+        Check whether this logger is enabled for the level whose
+        integer representation is passed as parameter. The check reads
+        the cached effective level, which is only computed again after
+        a configuration change.
+        */
+    public:
+        inline bool isEnabledFor(int level)
+        {
+            if (LOG4CXX_UNLIKELY(helpers::Atomic::get(&cachedGeneration)
+                != helpers::Atomic::get(generation)))
+            {
+                updateEnabledLevel();
+            }
+
+            return level >= enabledLevel;
+        }
+
         /**
         Check whether this logger is enabled for the info Level.
         See also #isDebugEnabled.
@@ -352,7 +483,32 @@ namespace log4cxx
         for level info, <code>false</code> otherwise.
         */
     public:
-        bool isInfoEnabled();
+        inline bool isInfoEnabled()
+            { return isEnabledFor(Level::INFO_INT); }
+
+        /**
+        Check whether this logger is enabled for the warn Level.
+        See also #isDebugEnabled.
+        */
+    public:
+        inline bool isWarnEnabled()
+            { return isEnabledFor(Level::WARN_INT); }
+
+        /**
+        Check whether this logger is enabled for the error Level.
+        See also #isDebugEnabled.
+        */
+    public:
+        inline bool isErrorEnabled()
+            { return isEnabledFor(Level::ERROR_INT); }
+
+        /**
+        Check whether this logger is enabled for the fatal Level.
+        See also #isDebugEnabled.
+        */
+    public:
+        inline bool isFatalEnabled()
+            { return isEnabledFor(Level::FATAL_INT); }
 
          /**
         This is the most generic printing method. It is intended to be
@@ -411,34 +567,64 @@ namespace log4cxx
     };
 };
 
+#if LOG4CXX_MIN_LEVEL > LOG4CXX_LEVEL_DEBUG
+#define LOG4CXX_DEBUG(logger, message) {}
+#else
 #define LOG4CXX_DEBUG(logger, message) { \
-	if (logger->isDebugEnabled()) {\
+	if (LOG4CXX_UNLIKELY(logger->isDebugEnabled())) {\
+	static ::log4cxx::spi::CallSite log4cxx_callSite = \
+		LOG4CXX_CALL_SITE_INIT(LOG4CXX_LEVEL_DEBUG); \
 	tostringstream oss; \
 	oss << message; \
-	logger->debug(oss.str(), __FILE__, __LINE__); }}
+	logger->forcedLog(::log4cxx::Level::DEBUG, oss.str(), log4cxx_callSite); }}
+#endif
 
+#if LOG4CXX_MIN_LEVEL > LOG4CXX_LEVEL_INFO
+#define LOG4CXX_INFO(logger, message) {}
+#else
 #define LOG4CXX_INFO(logger, message) { \
-	if (logger->isInfoEnabled()) {\
+	if (LOG4CXX_UNLIKELY(logger->isInfoEnabled())) {\
+	static ::log4cxx::spi::CallSite log4cxx_callSite = \
+		LOG4CXX_CALL_SITE_INIT(LOG4CXX_LEVEL_INFO); \
 	tostringstream oss; \
 	oss << message; \
-	logger->info(oss.str(), __FILE__, __LINE__); }}
+	logger->forcedLog(::log4cxx::Level::INFO, oss.str(), log4cxx_callSite); }}
+#endif
 
+#if LOG4CXX_MIN_LEVEL > LOG4CXX_LEVEL_WARN
+#define LOG4CXX_WARN(logger, message) {}
+#else
 #define LOG4CXX_WARN(logger, message) { \
-	if (logger->isWarnEnabled()) {\
+	if (LOG4CXX_UNLIKELY(logger->isWarnEnabled())) {\
+	static ::log4cxx::spi::CallSite log4cxx_callSite = \
+		LOG4CXX_CALL_SITE_INIT(LOG4CXX_LEVEL_WARN); \
 	tostringstream oss; \
 	oss << message; \
-	logger->warn(oss.str(), __FILE__, __LINE__); }}
+	logger->forcedLog(::log4cxx::Level::WARN, oss.str(), log4cxx_callSite); }}
+#endif
 
+#if LOG4CXX_MIN_LEVEL > LOG4CXX_LEVEL_ERROR
+#define LOG4CXX_ERROR(logger, message) {}
+#else
 #define LOG4CXX_ERROR(logger, message) { \
 	if (logger->isErrorEnabled()) {\
+	static ::log4cxx::spi::CallSite log4cxx_callSite = \
+		LOG4CXX_CALL_SITE_INIT(LOG4CXX_LEVEL_ERROR); \
 	tostringstream oss; \
 	oss << message; \
-	logger->error(oss.str(), __FILE__, __LINE__); }}
+	logger->forcedLog(::log4cxx::Level::ERROR, oss.str(), log4cxx_callSite); }}
+#endif
 
+#if LOG4CXX_MIN_LEVEL > LOG4CXX_LEVEL_FATAL
+#define LOG4CXX_FATAL(logger, message) {}
+#else
 #define LOG4CXX_FATAL(logger, message) { \
 	if (logger->isFatalEnabled()) {\
+	static ::log4cxx::spi::CallSite log4cxx_callSite = \
+		LOG4CXX_CALL_SITE_INIT(LOG4CXX_LEVEL_FATAL); \
 	tostringstream oss; \
 	oss << message; \
-	logger->fatal(oss.str(), __FILE__, __LINE__); }}
+	logger->forcedLog(::log4cxx::Level::FATAL, oss.str(), log4cxx_callSite); }}
+#endif
 
 #endif //_LOG4CXX_LOGGER_H
@@ -0,0 +1,176 @@
+/***************************************************************************
+                          mappedfileappender.h  -  class MappedFileAppender
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_MAPPED_FILE_APPENDER_H
+#define _LOG4CXX_MAPPED_FILE_APPENDER_H
+
+#include <log4cxx/rollingfileappender.h>
+
+namespace log4cxx
+{
+	/**
+	MappedFileAppender appends the log events to a file mapped in
+	memory, so that writing an event is a copy and involves no system
+	call.
+
+	<p>The file is grown and mapped by segments of <b>SegmentSize</b>
+	bytes, which are allocated on the disk before being mapped. The
+	file is truncated to the length of the text written when it is
+	closed or rolled over, which follows the options of
+	RollingFileAppender: <b>MaxFileSize</b> and <b>MaxBackupIndex</b>.
+	The events written are in the page cache of the system as soon as
+	they are copied, a crash of the process does not lose them. With
+	the <b>Append</b> option, the zeros which end a file that could not
+	be truncated are skipped when it is opened again.
+
+	<p>The <b>Sync</b> option of FileAppender is honored: with
+	<code>batch</code> the pages written are synchronized with
+	<code>msync</code> after each event or batch, with
+	<code>interval</code> the file is synchronized every
+	<b>FlushInterval</b> milliseconds. <b>BufferedIO</b> and
+	<b>RawIO</b> do not apply.
+
+	<p>Memory mapped files are available on POSIX systems in ANSI
+	builds. Elsewhere the appender behaves as a RollingFileAppender.
+	The file must not be truncated by another process while it is
+	mapped.
+	*/
+	class MappedFileAppender : public RollingFileAppender
+	{
+	public:
+		/** The default segment size is 16MB. */
+		static long DEFAULT_SEGMENT_SIZE;
+
+	protected:
+		/**
+		The number of bytes the file is grown and mapped by.
+		*/
+		long segmentSize;
+
+		/**
+		Is the file mapped? Set by #activateOptions.
+		*/
+		bool mapped;
+
+		/**
+		The mapped segment of the file, 0 if none.
+		*/
+		char * segment;
+
+		/**
+		The position of the segment in the file.
+		*/
+		long segmentStart;
+
+		/**
+		The length of the text written to the file.
+		*/
+		long tail;
+
+		/**
+		The length of the file when it was last synchronized.
+		*/
+		long syncedTail;
+
+	public:
+		MappedFileAppender();
+
+		/**
+		Instantiate a MappedFileAppender and open the file designated by
+		<code>filename</code>. The opened filename will become the ouput
+		destination for this appender.
+
+		<p>If the <code>append</code> parameter is true, the file will be
+		appended to. Otherwise, the file desginated by
+		<code>filename</code> will be truncated before being opened.
+		*/
+		MappedFileAppender(LayoutPtr layout, const tstring& fileName,
+			bool append);
+
+		~MappedFileAppender();
+
+		/**
+		Get the number of bytes the file is grown and mapped by.
+		*/
+		inline long getSegmentSize() const
+			{ return segmentSize; }
+
+		/**
+		Set the number of bytes the file is grown and mapped by. It is
+		rounded up to the page size of the system, and limited to
+		<b>MaxFileSize</b>.
+
+		<p>In configuration files, the <b>SegmentSize</b> option takes
+		a size with the same suffixes as <b>MaxFileSize</b>.
+		*/
+		inline void setSegmentSize(long segmentSize)
+			{ this->segmentSize = segmentSize; }
+
+		void activateOptions();
+		void setOption(const std::string& option,
+			const std::string& value);
+
+	protected:
+		/**
+		Open the file and map its last segment.
+		*/
+		bool openFile(bool append);
+
+		/**
+		Unmap the file, then truncate it to the length of the text.
+		*/
+		void closeFile();
+
+		long getFileLength();
+
+		void subAppend(const spi::LoggingEvent& event);
+		void subAppend(const spi::LoggingEvent& event,
+			const tstring& formatted);
+
+		/**
+		Copy the events of the batch one after the other, rolling over
+		as soon as the file is too large.
+		*/
+		void appendBatch(const spi::LoggingEventList& events);
+
+		void writeHeader();
+		void writeFooter();
+
+		/**
+		Copy the text at the end of the file, mapping the next segment
+		when the current one is full.
+		*/
+		void writeMapped(const TCHAR * text, size_t length);
+
+		/**
+		Unmap the current segment and map the one at
+		<code>start</code>, allocating it on the disk.
+		*/
+		bool mapSegment(long start);
+
+		/**
+		Synchronize the pages written since the last time with the
+		<b>Sync</b> option set to <code>batch</code>.
+		*/
+		void syncMapped();
+
+	private:
+		MappedFileAppender(const MappedFileAppender&);
+		MappedFileAppender& operator=(const MappedFileAppender&);
+	}; // class MappedFileAppender
+}; // namespace log4cxx
+
+#endif //_LOG4CXX_MAPPED_FILE_APPENDER_H
@@ -0,0 +1,214 @@
+/***************************************************************************
+                          mdc.h  -  class MDC
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_MDC_H
+#define _LOG4CXX_MDC_H
+
+#include <log4cxx/helpers/tchar.h>
+#include <log4cxx/helpers/threadspecificdata.h>
+#include <log4cxx/helpers/objectptr.h>
+#include <vector>
+
+namespace log4cxx
+{
+	/**
+	The MDC class is similar to the NDC class except that it is
+	based on a map instead of a stack. It provides <em>mapped
+	diagnostic contexts</em>. A <em>Mapped Diagnostic Context</em>, or
+	MDC in short, is an instrument for distinguishing interleaved log
+	output from different sources. Log output is typically interleaved
+	when a server handles multiple clients near-simultaneously.
+
+	<p><b><em>The MDC is managed on a per thread basis</em></b>.
+	MDC operations such as #put, #remove and #clear affect the MDC of
+	the <em>current</em> thread only.
+
+	<p>The keys are registered once and identified by an integer, so
+	that the PatternLayout resolves the key of a <b>\%X{key}</b>
+	conversion when the pattern is compiled and never hashes strings
+	while formatting an event. The keys already registered are looked
+	up without locking. The keys of the events received from other
+	processes are kept by name in the map of the event, they are not
+	registered.
+
+	<p>The map of a thread is a small flat array. A logging event
+	captures the map of its thread by taking a reference on it: the
+	map is copied by the next #put or #remove only if an event still
+	references it.
+	*/
+	class MDC
+	{
+	private:
+		// No instances allowed.
+		MDC() {}
+
+	public:
+		/**
+		Immutable once shared, reference counted map of a thread.
+		*/
+		class Map
+		{
+		public:
+			Map();
+			Map(const Map& map);
+
+			void addRef();
+			void releaseRef();
+
+			/**
+			Returns the value of the key identified by
+			<code>key</code>, or <code>0</code> if the map has no value
+			for it.
+			*/
+			const tstring * get(int key) const;
+
+			/**
+			Returns the value of <code>key</code>, or <code>0</code> if
+			the map has no value for it.
+			*/
+			const tstring * get(const tstring& key) const;
+
+			/** Number of keys in the map. */
+			inline int size() const
+				{ return entries.size(); }
+
+			/** Identifier of the key of the entry at
+			<code>index</code>, -1 for a key which is not registered. */
+			inline int getKey(int index) const
+				{ return entries[index].key; }
+
+			/** Name of the key of the entry at <code>index</code>. */
+			tstring getKeyName(int index) const;
+
+			/** Value of the entry at <code>index</code>. */
+			inline const tstring& getValue(int index) const
+				{ return entries[index].value; }
+
+			/**
+			Set the value of a key. Only the thread which owns a map not
+			shared with any event may modify it.
+			*/
+			void put(int key, const tstring& value);
+
+			/**
+			Add the value of a key received from another process. The
+			key is not registered, it is kept by name if it is not
+			known yet.
+			*/
+			void putRemote(const tstring& key, const tstring& value);
+
+			/**
+			Remove the value of a key. Only the thread which owns a map
+			not shared with any event may modify it.
+			*/
+			void remove(int key);
+
+			/** Returns <code>true</code> if a logging event or another
+			thread references this map too. */
+			bool isShared() const;
+
+		protected:
+			struct Entry
+			{
+				/** Identifier of the key, -1 if it is not
+				registered. */
+				int key;
+				/** Name of a key which is not registered. */
+				tstring name;
+				tstring value;
+			};
+
+			volatile long refCount;
+			std::vector<Entry> entries;
+
+			/** Number of entries whose key is not registered. */
+			int unregistered;
+
+		private:
+			Map& operator=(const Map&);
+		};
+
+		typedef helpers::ObjectPtr<Map> MapPtr;
+
+		/**
+		Returns the identifier of <code>key</code>, registering the key
+		if it is not known yet.
+		*/
+		static int getKeyId(const tstring& key);
+
+		/**
+		Returns the identifier of <code>key</code>, or -1 if the key is
+		not registered. It does not take any lock.
+		*/
+		static int findKeyId(const tstring& key);
+
+		/**
+		Returns the name of the key identified by <code>id</code>.
+		*/
+		static tstring getKeyName(int id);
+
+		/**
+		Put a context value (the <code>value</code> parameter) as
+		identified with the <code>key</code> parameter into the current
+		thread's context map.
+
+		<p>If the current thread does not have a context map it is
+		created as a side effect.
+		*/
+		static void put(const tstring& key, const tstring& value);
+
+		/**
+		Get the context identified by the <code>key</code> parameter.
+		Returns the empty string if the current thread has no value for
+		the key.
+
+		<p>This method has no side effects.
+		*/
+		static tstring get(const tstring& key);
+
+		/**
+		Remove the the context identified by the <code>key</code>
+		parameter.
+		*/
+		static void remove(const tstring& key);
+
+		/**
+		Clear the context map of the current thread.
+		*/
+		static void clear();
+
+		/**
+		Returns the context map of the current thread, or
+		<code>0</code> if it is empty. The map is borrowed, it remains
+		valid until the next modification of the context of the current
+		thread.
+		*/
+		static Map * getCurrentMap();
+
+	private:
+		static void setCurrentMap(Map * map);
+
+		/**
+		Returns the map of the current thread, copied first if it is
+		shared, so that the caller may modify it.
+		*/
+		static Map * getWritableMap();
+
+		static helpers::ThreadSpecificData threadSpecificData;
+	}; // class MDC
+}; // namespace log4cxx
+
+#endif // _LOG4CXX_MDC_H
@@ -19,13 +19,10 @@
 
 #include <log4cxx/helpers/tchar.h>
 #include <log4cxx/helpers/threadspecificdata.h>
-#include <stack>
+#include <log4cxx/helpers/objectptr.h>
 
 namespace log4cxx
 {
-	class DiagnosticContext;
-	typedef std::stack<DiagnosticContext> Stack;
-
 	/**
 	the ndc class implements <i>nested diagnostic contexts</i> as
 	defined by neil harrison in the article "patterns for logging
@@ -99,20 +96,83 @@ namespace log4cxx
 		// No instances allowed.
 		NDC() {}
 
+	public:
+		/**
+		A frame of a nested diagnostic context. Frames are immutable
+		and reference counted: each frame holds a reference on the
+		frame it was pushed onto, so that the frames of a thread form a
+		persistent stack. Pushing a context or capturing the context of
+		a logging event is done in constant time, and the contexts of
+		several threads or events share their common frames.
+		*/
 		class DiagnosticContext
 		{
 		public:
-			tstring fullMessage;
+			DiagnosticContext(const tstring& message,
+				DiagnosticContext * parent);
+			~DiagnosticContext();
+
+			void addRef();
+			void releaseRef();
+
+			/** The message pushed with this frame. */
+			inline const tstring& getMessage() const
+				{ return message; }
+
+			/** The frame this frame was pushed onto, or
+			<code>0</code>. */
+			inline DiagnosticContext * getParent() const
+				{ return parent; }
+
+			/** The number of frames from the bottom of the stack to
+			this frame included. */
+			inline int getDepth() const
+				{ return depth; }
+
+			/**
+			The messages of the frames from the bottom of the stack to
+			this frame, separated by spaces. The string is built on the
+			first call only.
+			*/
+			const tstring& getFullMessage();
+
+		protected:
+			volatile long refCount;
 			tstring message;
-    
-			DiagnosticContext(const tstring& message, 
-				const DiagnosticContext * parent);
+			DiagnosticContext * parent;
+			int depth;
+			tstring * volatile fullMessage;
+
+		private:
+			DiagnosticContext(const DiagnosticContext&);
+			DiagnosticContext& operator=(const DiagnosticContext&);
 		};
 
-		typedef std::stack<DiagnosticContext> Stack;
+		typedef helpers::ObjectPtr<DiagnosticContext> DiagnosticContextPtr;
 
-		static Stack * getCurrentThreadStack();
-		static void setCurrentThreadStack(Stack * stack);
+		/**
+		The diagnostic context of a thread, as returned by #cloneStack.
+		*/
+		class Stack
+		{
+		public:
+			Stack(DiagnosticContext * top = 0) : top(top) {}
+
+			/** The innermost frame, <code>0</code> if the stack is
+			empty. */
+			DiagnosticContextPtr top;
+		};
+
+		/**
+		Returns the innermost frame of the diagnostic context of the
+		current thread, or <code>0</code> if the context is empty.
+		The frame is borrowed, it remains valid until the next
+		modification of the context of the current thread.
+		*/
+		static DiagnosticContext * getCurrentContext();
+
+	private:
+		static void setCurrentContext(DiagnosticContext * context);
 
 		static helpers::ThreadSpecificData threadSpecificData;
 
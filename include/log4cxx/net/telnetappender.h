@@ -62,8 +62,10 @@ namespace log4cxx
 		*/
         class TelnetAppender : public AppenderSkeleton
 		{
-		class SocketHandler;
-		friend class SocketHandler;
+		protected:
+			class SocketHandler;
+			friend class SocketHandler;
+
 		private:
 			static int DEFAULT_PORT;
 			SocketHandler * sh;
@@ -18,14 +18,13 @@
 #define _LOG4CXX_PATTERN_LAYOUT_H
 
 #include <log4cxx/layout.h>
+#include <log4cxx/helpers/patternconverter.h>
+#include <log4cxx/helpers/threadspecificdata.h>
+#include <log4cxx/helpers/hazardpointer.h>
+#include <vector>
 
 namespace log4cxx
 {
-	namespace helpers
-	{
-		class PatternConverter;
-		typedef ObjectPtr<PatternConverter> PatternConverterPtr;
-	};
 
 	/**
 
@@ -129,6 +128,8 @@ namespace log4cxx
 	<li>%Y -- Year including century as decimal
 	<li>%Z -- Time zone name
 	<li>%% -- The percent sign
+	<li>SSS -- Milliseconds (000-999)
+	<li>SSSSSS -- Microseconds (000000-999999)
 
 	<p>Lookup the documentation for the <code>strftime()</code> function
 	found in the <code>&lt;ctime&gt;</code> header for more information.
@@ -150,12 +151,14 @@ namespace log4cxx
 	<tr>
 	<td align=center><b>F</b></td>
 
-	<td>Used to output the file name where the logging request was
-	issued.
+	<td>Used to output the file name, without its directories, where
+	the logging request was issued. The versions before the call site
+	descriptors printed the whole path given by <code>__FILE__</code>,
+	which depends on how the sources were compiled.
 
-	<p><b>WARNING</b> Generating caller location information is
-	extremely slow. It's use should be avoided unless execution speed
-	is not an issue.
+	<p>The location information is only known for the requests issued
+	with the <code>LOG4CXX_*</code> macros, or with an explicit file
+	and line.
 
 	</tr>
 
@@ -163,11 +166,12 @@ namespace log4cxx
 	<td align=center><b>l</b></td>
 
 	<td>Used to output location information of the caller which generated
-	the logging event.
+	the logging event, as <code>file(line)</code> with the file without
+	its directories, as for the <b>F</b> conversion character.
 
-	<p>The location information can be very useful. However, it's
-	generation is <em>extremely</em> slow. It's use should be avoided
-	unless execution speed is not an issue.
+	<p>The location information is taken from the static descriptor
+	of the statement, so that printing it costs little more than
+	printing the message.
 
 	</td>
 	</tr>
@@ -178,9 +182,14 @@ namespace log4cxx
 	<td>Used to output the line number from where the logging request
 	was issued.
 
-	<p><b>WARNING</b> Generating caller location information is
-	extremely slow. It's use should be avoided unless execution speed
-	is not an issue.
+	</tr>
+
+	<tr>
+	<td align=center><b>M</b></td>
+
+	<td>Used to output the function name where the logging request was
+	issued. The function name is only known for the requests issued
+	with the <code>LOG4CXX_*</code> macros.
 
 	</tr>
 
@@ -223,7 +232,9 @@ namespace log4cxx
 	<td align=center><b>t</b></td>
 
 	<td>Used to output the name of the thread that generated the
-	logging event.</td>
+	logging event. Threads without a name, see
+	helpers::ThreadIdentity#setCurrentName, are identified by a number
+	given the first time they log.</td>
 
 	</tr>
 
@@ -392,9 +403,23 @@ namespace log4cxx
 		// output buffer appended to when format() is invoked
 		tostringstream sbuf;
 		tstring pattern;
-		helpers::PatternConverterPtr head;
 		tstring timezone;
 
+		/** The converters of the pattern compiled into a flat
+		instruction array, defined in the implementation file. */
+		struct Program;
+
+		/** The current program, replaced as a whole by
+		#activateOptions and read under a helpers::HazardPointer. */
+		Program * volatile program;
+
+		/** The programs replaced while a thread could still read them,
+		deleted as soon as no thread protects them. */
+		helpers::RetiredList<Program> retiredPrograms;
+
+		/** Buffer of each thread the events are formatted into. */
+		static helpers::ThreadSpecificData buffer;
+
 	public:
 		/**
 		Does nothing
@@ -406,6 +431,8 @@ namespace log4cxx
 		*/
 		PatternLayout(const tstring& pattern);
 
+		~PatternLayout();
+
 		/**
 		Set the <b>ConversionPattern</b> option. This is the string which
 		controls formatting and consists of a mix of literal content and
@@ -439,6 +466,12 @@ namespace log4cxx
 		*/
 		virtual void format(tostream& output, const spi::LoggingEvent& event);
 
+		/**
+		Appends the event formatted as specified by the conversion
+		pattern to <code>output</code>.
+		*/
+		virtual void format(tstring& output, const spi::LoggingEvent& event);
+
 	protected:
 		/**
 		Returns head of PatternParser used to parse the conversion string. 
@@ -128,6 +128,20 @@ namespace log4cxx
 		class.
 		*/
 		virtual void subAppend(const spi::LoggingEvent& event);
+
+		/**
+		Write an event already formatted by the layout, then roll over
+		if the file is too large.
+		*/
+		virtual void subAppend(const spi::LoggingEvent& event,
+			const tstring& formatted);
+
+		/**
+		Write the batch, then roll over if the file is too large. With
+		the <b>RawIO</b> option the batch is written at once, so that
+		the file may exceed <code>MaxFileSize</code> by one batch.
+		*/
+		virtual void appendBatch(const spi::LoggingEventList& events);
 	}; // class RollingFileAppender
 }; // namespace log4cxx
 
@@ -0,0 +1,93 @@
+/***************************************************************************
+                          callsite.h  -  struct CallSite
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_SPI_CALL_SITE_H
+#define _LOG4CXX_SPI_CALL_SITE_H
+
+#include <log4cxx/helpers/tchar.h>
+
+#if defined(__GNUC__) || (defined(_MSC_VER) && _MSC_VER >= 1300)
+#define LOG4CXX_FUNCTION __FUNCTION__
+#else
+#define LOG4CXX_FUNCTION 0
+#endif
+
+/**
+Initializer of the static CallSite of a log statement written at the
+place where the macro is expanded. All the members are constant
+expressions, so that the descriptor is initialized at compile time.
+*/
+#define LOG4CXX_CALL_SITE_INIT(level) \
+	{ __FILE__, LOG4CXX_FUNCTION, __LINE__, level, 0, 0, 0 }
+
+namespace log4cxx
+{
+	namespace spi
+	{
+		/**
+		Descriptor of a log statement. The <code>LOG4CXX_*</code>
+		macros define one static descriptor per statement, and the
+		logging events reference it instead of copying the location
+		information. The events logged with an explicit file and line,
+		or read from a socket, have no descriptor.
+
+		<p>The file name without its directories and the function name
+		are converted to TCHAR text the first time a layout asks for
+		them, then cached in the descriptor.
+		*/
+		struct CallSite
+		{
+			/** File of the statement, as given by
+			<code>__FILE__</code>, or <code>0</code> if unknown. */
+			const char * file;
+
+			/** Function of the statement, or <code>0</code> if
+			unknown. */
+			const char * function;
+
+			/** Line of the statement, or -1 if unknown. */
+			int line;
+
+			/** Level of the statement, see LOG4CXX_LEVEL_DEBUG, or 0
+			if unknown. */
+			int level;
+
+			// caches, initialized to 0
+			const TCHAR * volatile fileName;
+			const TCHAR * volatile functionName;
+			volatile long id;
+
+			/** Returns the file name without its directories, or
+			<code>0</code>. */
+			const TCHAR * getFileName();
+
+			/** Returns the function name, or <code>0</code>. */
+			const TCHAR * getFunctionName();
+
+			/** Returns a number derived from the file name without
+			its directories and the line of this call site, the same in
+			each run of the application whatever the order in which the
+			statements run. The statements written on the same line of a
+			file share it. */
+			long getId();
+
+			/** Returns <code>path</code> without its directories. */
+			static const char * getBaseName(const char * path);
+		};
+	}; // namespace spi
+}; // namespace log4cxx
+
+#endif //_LOG4CXX_SPI_CALL_SITE_H
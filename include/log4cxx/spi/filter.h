@@ -20,9 +20,13 @@
 #include <log4cxx/helpers/objectptr.h>
 #include <log4cxx/helpers/objectimpl.h>
 #include <log4cxx/spi/optionhandler.h>
+#include <log4cxx/helpers/atomic.h>
 
 namespace log4cxx
 {
+	class Level;
+	class Appender;
+
 	namespace spi
 	{
 		class Filter;
@@ -74,6 +78,14 @@ namespace log4cxx
             */
             FilterPtr next;
 
+		protected:
+            /**
+            The appender this filter was added to, 0 if none. The appender
+            owns its filters, the filter does not hold a reference to it.
+            */
+            Appender * volatile owner;
+
+		public:
             enum FilterDecision
             {
             /**
@@ -94,6 +106,8 @@ namespace log4cxx
 			};
 
 
+            Filter() : owner(0) {}
+
             /**
             Usually filters options become active when set. We provide a
 
@@ -112,6 +126,43 @@ namespace log4cxx
             @param event The LoggingEvent to decide upon.
             @return The decision of the filter.  */
             virtual int decide(const LoggingEvent& event) = 0;
+
+            /**
+            Returns <code>true</code> if the decision of this filter only
+            depends on the level of the event. The appenders then ask
+            #decideLevel once per level when their chain is compiled, and
+            never call #decide.
+            */
+            virtual bool isLevelFilter() const { return false; }
+
+            /**
+            Returns the decision of this filter for all the events of
+            <code>level</code>. Only called if #isLevelFilter returns
+            <code>true</code>.
+            */
+            virtual int decideLevel(const Level& /* level */) { return NEUTRAL; }
+
+            /**
+            Set the appender this filter was added to, 0 when it is
+            removed or closed. Called by the appender.
+            */
+            inline void setOwner(Appender * owner)
+                { helpers::Atomic::setPointer((void * volatile *)&this->owner,
+                  owner); }
+
+            /**
+            Returns the appender this filter was added to, 0 if none.
+            */
+            inline Appender * getOwner() const
+                { return (Appender *)helpers::Atomic::getPointer(
+                  (void * const volatile *)&owner); }
+
+            /**
+            Append to the owner the events the filter holds back, such as
+            the summaries of the events it denied. Called by the appender
+            before it is closed, it does nothing by default.
+            */
+            virtual void flush() {}
 		};
 	};
 };
@@ -93,6 +93,15 @@ namespace log4cxx
 			for an explanation. */
             virtual const Level& getThreshold() = 0;
 
+            /**
+            Returns the address of the generation counter of the
+            repository. The counter is incremented each time a logger
+            level, the threshold, the structure of the repository, the
+            appenders or the additivity of a logger changes, so that
+            loggers know when their cached effective level and appender
+            route are out of date. */
+            virtual volatile long * getGenerationCounter() = 0;
+
             virtual LoggerPtr getLogger(const tstring& name) = 0;
 
             virtual LoggerPtr getLogger(const tstring& name, LoggerFactoryPtr 
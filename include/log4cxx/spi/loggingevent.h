@@ -21,6 +21,10 @@
 #include <log4cxx/helpers/tchar.h>
 #include <time.h>
 #include <log4cxx/logger.h>
+#include <log4cxx/ndc.h>
+#include <log4cxx/mdc.h>
+#include <log4cxx/helpers/threadidentity.h>
+#include <log4cxx/spi/callsite.h>
 
 namespace log4cxx
 {
@@ -57,6 +61,15 @@ namespace log4cxx
 			/** For serialization only
 			*/
 			LoggingEvent();
+
+			/**
+			Copy <code>event</code> into this event. The text of the
+			message and of the file is copied into the strings of this
+			event, which keep their capacity, so that the events reused
+			by LoggingEventPool, RingBuffer and AsyncAppender do not
+			allocate once they have grown.
+			*/
+			LoggingEvent& operator=(const LoggingEvent& event);
 			
 			/**
 			Instantiate a LoggingEvent from the supplied parameters.
@@ -73,6 +86,17 @@ namespace log4cxx
 			LoggingEvent(const LoggerPtr& logger, const Level& level,
 				const tstring& message, const char* file=0, int line=-1);
 
+			/**
+			Instantiate a LoggingEvent logged by the statement described
+			by <code>callSite</code>.
+			*/
+			LoggingEvent(const LoggerPtr& logger, const Level& level,
+				const tstring& message, CallSite& callSite);
+
+			/** Return the #logger of this event. */
+			inline const LoggerPtr& getLogger() const
+				{ return logger; }
+
 			/**  Return the name of the #logger. */
 			inline const tstring& getLoggerName() const
 				{ return logger->getName(); }
@@ -89,29 +113,86 @@ namespace log4cxx
 			inline time_t getTimeStamp() const
 				{ return timeStamp; }
 
-			/** Return the #threadId of this event. */
+			/** Return the microseconds elapsed in the second of the
+			#timeStamp of this event. */
+			inline long getMicroseconds() const
+				{ return microseconds; }
+
+			/** Return the milliseconds elapsed from the startup of the
+			application until this event was created. */
+			inline long getRelativeTime() const
+				{ return (long)(timeStamp - startTime) * 1000
+					+ (microseconds - startMicroseconds) / 1000; }
+
+			/** Return the number of the thread of this event. See
+			helpers::ThreadIdentity. */
 			inline unsigned long getThreadId() const
-				{ return threadId; }
+				{ return threadIdentity == 0 ? 0 : threadIdentity->getId(); }
+
+			/** Return the text printed by the layouts for the thread of
+			this event: its name if it is set, its number otherwise. */
+			const tstring& getThreadName() const;
+
+			/** Return the identity of the thread of this event. */
+			inline helpers::ThreadIdentity * getThreadIdentity() const
+				{ return threadIdentity; }
 
 			/* Return the file where this log statement was written. */
-			inline char * getFile() const
-				{ return file; }
+			char * getFile() const;
 
 			/* Return the line where this log statement was written. */
 			inline int getLine() const
-				{ return line; }
+				{ return callSite == 0 ? line : callSite->line; }
+
+			/** Return the file where this log statement was written,
+			without its directories, or <code>0</code>. The layouts
+			print this name, #getFile returns the whole path. */
+			const TCHAR * getFileName() const;
+
+			/** Return the function where this log statement was
+			written, or <code>0</code>. */
+			inline const TCHAR * getFunctionName() const
+				{ return callSite == 0 ? 0 : callSite->getFunctionName(); }
+
+			/** Return the descriptor of the statement which logged this
+			event, or <code>0</code> if the location is unknown. */
+			inline CallSite * getCallSite() const
+				{ return callSite; }
 
 			/**
 			* This method returns the NDC for this event. It will return the
 			* correct content even if the event was generated in a different
 			* thread or even on a different machine. The NDC#get method
-			* should <em>never</em> be called directly.  */
+			* should <em>never</em> be called directly.
+			*
+			* <p>The event only holds a reference on the innermost NDC
+			* frame of the thread which created it. The full string is
+			* built the first time a layout asks for it.  */
 			const tstring& getNDC() const;
 
-			/** Write this event to a helpers::SocketOutputStream. */
+			/**
+			Returns the value of the MDC key identified by
+			<code>key</code> when the event was created, or the empty
+			string. See MDC#getKeyId. */
+			const tstring& getMDC(int key) const;
+
+			/**
+			Returns the value of the MDC key <code>key</code> when the
+			event was created, or the empty string. */
+			const tstring& getMDC(const tstring& key) const;
+
+			/** Returns the MDC map captured when the event was created,
+			or <code>0</code> if it was empty. */
+			inline MDC::Map * getMDCMap() const
+				{ return mdc; }
+
+			/** Write this event to a helpers::SocketOutputStream,
+			preceded by the version of the format. */
 			void write(helpers::SocketOutputStreamPtr os) const;
 
-			/** Read this event from a helpers::SocketOutputStream. */
+			/** Read this event from a helpers::SocketInputStream.
+			Throws helpers::SocketException if the format version is
+			unknown or the event has more than 256 MDC keys. */
 			void read(helpers::SocketInputStreamPtr is);
 
 			/**Returns the time when the application started,
@@ -120,12 +201,18 @@ namespace log4cxx
 			static long getStartTime()
 				{ return startTime; }
 
+			/** Returns the microseconds elapsed in the second the
+			application started. */
+			static long getStartMicroseconds()
+				{ return startMicroseconds; }
+
 			/** Obtain a copy a this event. */
 			LoggingEvent * copy() const;
 
 			/**
 			Obtain a copy of this thread's MDC prior to serialization
-			or asynchronous logging.
+			or asynchronous logging. The map of the thread is captured
+			when the event is created, this method does nothing.
 			*/
 			void getMDCCopy() const {}
 		private:
@@ -144,29 +231,45 @@ namespace log4cxx
             /** The number of seconds elapsed from 1/1/1970 until logging event
             was created. */
             time_t timeStamp;
+			/** The microseconds elapsed in the second of timeStamp. */
+			long microseconds;
+
+			/** The descriptor of the statement which logged this event,
+			if it was logged by one of the <code>LOG4CXX_*</code> macros.
+			*/
+			CallSite * callSite;
 
-			/** The is the file where this log statement was written. */
-			char* file;
+			/** The file where this log statement was written, if there is
+			no #callSite. */
+			const char * file;
 
-			/** The is the line where this log statement was written. */
+			/** The line where this log statement was written, if there is
+			no #callSite. */
 			int line;
 
-			/** Have we tried to do an NDC lookup? If we did, there is no need
-			*  to do it again.  Note that its value is always false when
-			*  serialized. Thus, a receiving SocketNode will never use it's own
-			*  (incorrect) NDC. See also writeObject method.
-			*/
-			bool ndcLookupRequired;
+			/** The file read from a socket, or in Unicode builds the
+			conversion of #file. */
+			tstring fileText;
+
+			/** The innermost frame of the nested diagnostic context (NDC)
+			of the logging event, captured when the event is created. A
+			received event holds a single frame with the NDC read from the
+			stream, so that a receiving SocketNode never uses its own
+			(incorrect) NDC. */
+			NDC::DiagnosticContextPtr ndc;
 
-			/** The nested diagnostic context (NDC) of logging event. */
-			tstring ndc;
+			/** The mapped diagnostic context (MDC) of the thread in
+			which this logging event was generated, captured when the
+			event is created. */
+			MDC::MapPtr mdc;
 
-			/** The identifier of thread in which this logging event
+			/** The identity of the thread in which this logging event
 			was generated.
 			*/
-			unsigned long threadId;
+			helpers::ThreadIdentityPtr threadIdentity;
 
 			static time_t startTime;
+			static long startMicroseconds;
   		};
 	};
 };
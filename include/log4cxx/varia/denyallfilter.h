@@ -46,6 +46,12 @@ namespace log4cxx
 			*/
 			int decide(const spi::LoggingEvent& event)
 				{ return spi::Filter::DENY; }
+
+			bool isLevelFilter() const
+				{ return true; }
+
+			int decideLevel(const Level& /* level */)
+				{ return spi::Filter::DENY; }
 		}; // class DenyAllFilter
 	}; // namespace varia
 }; // namespace log4cxx
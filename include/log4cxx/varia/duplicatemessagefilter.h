@@ -0,0 +1,151 @@
+/***************************************************************************
+                          duplicatemessagefilter.h  -  class DuplicateMessageFilter
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_VARIA_DUPLICATE_MESSAGE_FILTER_H
+#define _LOG4CXX_VARIA_DUPLICATE_MESSAGE_FILTER_H
+
+#include <log4cxx/spi/filter.h>
+#include <log4cxx/helpers/threadspecificdata.h>
+#include <log4cxx/helpers/criticalsection.h>
+#include <log4cxx/logger.h>
+
+namespace log4cxx
+{
+	class Level;
+
+	namespace spi
+	{
+		class LoggingEvent;
+		struct CallSite;
+	};
+
+	namespace varia
+	{
+		/**
+		This filter collapses the identical events logged in a burst.
+
+		<p>The filter admits two options <b>Key</b> and <b>Window</b>.
+
+		<p>Two events are identical when they have the same logger and
+		level, and the same message if <b>Key</b> is <code>message</code>
+		(the default) or the same location if <b>Key</b> is
+		<code>location</code>. The first of a series of identical events
+		gets {@link spi::Filter#NEUTRAL NEUTRAL}, the ones logged less
+		than <b>Window</b> milliseconds after it get
+		{@link spi::Filter#DENY DENY}.
+
+		<p>The number of denied events is appended as a <i>Last message
+		repeated N times</i> summary to the appender the filter was
+		added to, at the level of the series, when the series ends:
+		the message is logged again after the window, another series
+		takes its place in the bounded table of the filter, the first
+		event of any series is logged after the window, or the appender
+		is closed.
+		*/
+		class DuplicateMessageFilter : public spi::Filter
+		{
+		private:
+			static tstring KEY_OPTION;
+			static tstring WINDOW_OPTION;
+
+			enum { MAX_SERIES = 256 };
+
+			struct Series
+			{
+				helpers::CriticalSection cs;
+				unsigned long hash;
+				LoggerPtr logger;
+				const Level * level;
+				spi::CallSite * callSite;
+				tstring message;
+				long first;
+				long repeats;
+			};
+
+			Series * series;
+			bool keyByLocation;
+			long window;
+
+			/** The end of the first window of a series with denied
+			events, in milliseconds since startup. */
+			volatile long nextExpiry;
+
+			/** The filter reporting a summary on this thread. */
+			static helpers::ThreadSpecificData reporting;
+
+		public:
+			DuplicateMessageFilter();
+			~DuplicateMessageFilter();
+
+			/**
+			Set options
+			*/
+			virtual void setOption(const tstring& option,
+				const tstring& value);
+
+			/**
+			Compare the locations of the events if
+			<code>keyByLocation</code> is true, their messages otherwise.
+			*/
+			inline void setKeyByLocation(bool keyByLocation)
+				{ this->keyByLocation = keyByLocation; }
+
+			inline bool getKeyByLocation() const
+				{ return keyByLocation; }
+
+			/** Set the milliseconds during which the identical events
+			are collapsed. */
+			inline void setWindow(long window)
+				{ this->window = window; }
+
+			inline long getWindow() const
+				{ return window; }
+
+			/**
+			Returns {@link spi::Filter#DENY DENY} if the event repeats
+			the series in progress, {@link spi::Filter#NEUTRAL NEUTRAL}
+			otherwise.
+			*/
+			int decide(const spi::LoggingEvent& event);
+
+			/**
+			Append the summaries of all the series with denied events.
+			*/
+			void flush();
+
+		protected:
+			/**
+			End the series with denied events whose window ended before
+			<code>now</code>, or all of them if <code>all</code> is true,
+			and append their summaries.
+			*/
+			void endSeries(long now, bool all);
+
+			/** Lower #nextExpiry to <code>expiry</code>. */
+			void setNextExpiry(long expiry);
+
+			void report(const LoggerPtr& logger, const Level& level,
+				spi::CallSite * callSite, const tstring& message,
+				long repeats);
+
+		private:
+			DuplicateMessageFilter(const DuplicateMessageFilter&);
+			DuplicateMessageFilter& operator=(const DuplicateMessageFilter&);
+		}; // class DuplicateMessageFilter
+	}; // namespace varia
+}; // namespace log4cxx
+
+#endif // _LOG4CXX_VARIA_DUPLICATE_MESSAGE_FILTER_H
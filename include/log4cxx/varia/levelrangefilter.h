@@ -130,6 +130,12 @@ namespace log4cxx
 			<b>AcceptOnMatch</b> property is set to false.
 			*/
 			int decide(const spi::LoggingEvent& event);
+
+			/** The decision only depends on the level. */
+			bool isLevelFilter() const
+				{ return true; }
+
+			int decideLevel(const Level& level);
 		}; // class LevelMatchFilter
 	}; // namespace varia
 }; // namespace log4cxx
@@ -0,0 +1,120 @@
+/***************************************************************************
+                          multistringmatchfilter.h  -  class MultiStringMatchFilter
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_VARIA_MULTI_STRING_MATCH_FILTER_H
+#define _LOG4CXX_VARIA_MULTI_STRING_MATCH_FILTER_H
+
+#include <log4cxx/spi/filter.h>
+#include <log4cxx/helpers/hazardpointer.h>
+#include <vector>
+
+namespace log4cxx
+{
+	namespace spi
+	{
+		class LoggingEvent;
+	};
+
+	namespace varia
+	{
+		/**
+		This filter matches the message of the events against a set of
+		strings in a single pass, whatever the number of strings.
+
+		<p>The filter admits two options <b>Accept</b> and <b>Deny</b>,
+		which can be given any number of times, each one adding a string
+		to match. If the message of the {@link spi::LoggingEvent
+		LoggingEvent} contains some of the strings, the one which was
+		added first decides: {@link spi::Filter#ACCEPT ACCEPT} if it was
+		given with <b>Accept</b>, {@link spi::Filter#DENY DENY} if it was
+		given with <b>Deny</b>. Otherwise
+		{@link spi::Filter#NEUTRAL NEUTRAL} is returned.
+
+		<p>The decisions are the same as the ones of a chain of
+		StringMatchFilter, one per string, in the same order. The
+		strings are compiled into an Aho-Corasick automaton, so that
+		each character of the message is read once.
+
+		<p>The automaton takes one map entry per character of the
+		strings, and a row of 256 transitions for at most the
+		DENSE_STATE_COUNT states closest to its root, that is 64 KB
+		whatever the number of strings. The deeper states follow their
+		failure links.
+
+		<p>#addString and #clear compile a new automaton and replace the
+		current one as a whole, the events being decided meanwhile keep
+		the previous one.
+		*/
+		class MultiStringMatchFilter : public spi::Filter
+		{
+		private:
+			static tstring ACCEPT_OPTION;
+			static tstring DENY_OPTION;
+
+			enum { ALPHABET_SIZE = 256, DENSE_STATE_COUNT = 64 };
+
+			struct Pattern
+			{
+				tstring text;
+				bool accept;
+			};
+
+			std::vector<Pattern> patterns;
+
+			/** The strings compiled, defined in the implementation
+			file. */
+			struct Automaton;
+
+			/** The current automaton, 0 without strings, read under a
+			helpers::HazardPointer. */
+			Automaton * volatile automaton;
+
+			/** The automata replaced while a thread could still read
+			them. */
+			helpers::RetiredList<Automaton> retiredAutomata;
+
+		public:
+			MultiStringMatchFilter();
+			~MultiStringMatchFilter();
+
+			/**
+			Set options
+			*/
+			virtual void setOption(const tstring& option,
+				const tstring& value);
+
+			/**
+			Add a string to match, the events containing it are accepted
+			if <code>accept</code> is true, denied otherwise.
+			*/
+			void addString(const tstring& stringToMatch, bool accept);
+
+			/** Remove all the strings. */
+			void clear();
+
+			/**
+			Returns {@link spi::Filter#NEUTRAL NEUTRAL}
+			is there is no string match.
+			*/
+			int decide(const spi::LoggingEvent& event);
+
+		protected:
+			void compile();
+		}; // class MultiStringMatchFilter
+	}; // namespace varia
+}; // namespace log4cxx
+
+#endif // _LOG4CXX_VARIA_MULTI_STRING_MATCH_FILTER_H
@@ -0,0 +1,180 @@
+/***************************************************************************
+                          ratelimitfilter.h  -  class RateLimitFilter
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_VARIA_RATE_LIMIT_FILTER_H
+#define _LOG4CXX_VARIA_RATE_LIMIT_FILTER_H
+
+#include <log4cxx/spi/filter.h>
+#include <log4cxx/helpers/threadspecificdata.h>
+
+namespace log4cxx
+{
+	class Level;
+	class Logger;
+
+	namespace spi
+	{
+		class LoggingEvent;
+		struct CallSite;
+	};
+
+	namespace varia
+	{
+		/**
+		This filter limits the number of events logged per second by
+		each log statement, or by each logger.
+
+		<p>The filter admits four options <b>Key</b>, <b>Rate</b>,
+		<b>Burst</b> and <b>SampleRate</b>.
+
+		<p>Each key, which is the location of the statement if
+		<b>Key</b> is <code>location</code> (the default) or the logger
+		if <b>Key</b> is <code>logger</code>, owns a token bucket which
+		holds at most <b>Burst</b> events and is refilled with
+		<b>Rate</b> events per second. An event which finds a token
+		in the bucket of its key gets {@link spi::Filter#NEUTRAL
+		NEUTRAL}. Otherwise, it is {@link spi::Filter#DENY DENY}, unless
+		<b>SampleRate</b> is set to N, in which case one of every N
+		events over the limit is still let through.
+
+		<p>The number of denied events of each key is appended as a
+		summary to the appender the filter was added to, at the level of
+		the last denied event: before the next event of the key which
+		gets a token, at the first event of any key once a second has
+		passed, and when the appender is closed.
+
+		<p>The state of the keys is kept in a fixed table updated
+		without locking. The events of the statements without a location
+		are keyed by their logger. A key whose bucket is full again and
+		has nothing to report gives its place to a new key. When no
+		place is found, the new keys share one more bucket, so that
+		they are still limited together.
+		*/
+		class RateLimitFilter : public spi::Filter
+		{
+		private:
+			static tstring KEY_OPTION;
+			static tstring RATE_OPTION;
+			static tstring BURST_OPTION;
+			static tstring SAMPLE_RATE_OPTION;
+
+			enum { MAX_KEYS = 1024, MAX_PROBES = 16 };
+
+			struct Slot
+			{
+				void * volatile key;
+				/** Thousandths of event taken from the bucket. */
+				volatile long used;
+				/** Milliseconds since startup of the last refill. */
+				volatile long lastRefill;
+				volatile long suppressed;
+				volatile long overLimit;
+				/** The location of the key, 0 for a logger. */
+				spi::CallSite * volatile callSite;
+				/** The logger and level of the last denied event. */
+				Logger * volatile logger;
+				const Level * volatile level;
+			};
+
+			Slot * slots;
+			/** The bucket shared by the keys without a slot. */
+			Slot overflow;
+			/** When the slots are flushed next, in milliseconds since
+			startup. */
+			volatile long nextFlush;
+			bool keyByLogger;
+			int rate;
+			int burst;
+			int sampleRate;
+
+			/** The filter reporting a summary on this thread. */
+			static helpers::ThreadSpecificData reporting;
+
+		public:
+			RateLimitFilter();
+			~RateLimitFilter();
+
+			/**
+			Set options
+			*/
+			virtual void setOption(const tstring& option,
+				const tstring& value);
+
+			/**
+			Key the events by logger if <code>keyByLogger</code> is
+			true, by location otherwise.
+			*/
+			inline void setKeyByLogger(bool keyByLogger)
+				{ this->keyByLogger = keyByLogger; }
+
+			inline bool getKeyByLogger() const
+				{ return keyByLogger; }
+
+			/** Set the number of events per second of each key. */
+			inline void setRate(int rate)
+				{ this->rate = rate > 0 ? rate : 1; }
+
+			inline int getRate() const
+				{ return rate; }
+
+			/** Set the number of events each key can log at once. */
+			inline void setBurst(int burst)
+				{ this->burst = burst > 0 ? burst : 1; }
+
+			inline int getBurst() const
+				{ return burst; }
+
+			/** Let one of every <code>sampleRate</code> events over the
+			limit through, 0 denies all of them. */
+			inline void setSampleRate(int sampleRate)
+				{ this->sampleRate = sampleRate > 0 ? sampleRate : 0; }
+
+			inline int getSampleRate() const
+				{ return sampleRate; }
+
+			/**
+			Returns {@link spi::Filter#NEUTRAL NEUTRAL} if the key of
+			the event is under its limit or if the event is sampled,
+			{@link spi::Filter#DENY DENY} otherwise.
+			*/
+			int decide(const spi::LoggingEvent& event);
+
+			/**
+			Append the summaries of all the keys with denied events.
+			*/
+			void flush();
+
+		protected:
+			/**
+			Find the slot of <code>key</code>, claiming a free or stale
+			one, or returns the overflow bucket.
+			*/
+			Slot * findSlot(void * key, const spi::LoggingEvent& event);
+
+			/**
+			Append the summary of the events denied in
+			<code>slot</code>, if any, to the owner of the filter.
+			*/
+			void report(Slot * slot);
+
+		private:
+			RateLimitFilter(const RateLimitFilter&);
+			RateLimitFilter& operator=(const RateLimitFilter&);
+		}; // class RateLimitFilter
+	}; // namespace varia
+}; // namespace log4cxx
+
+#endif // _LOG4CXX_VARIA_RATE_LIMIT_FILTER_H
@@ -103,6 +103,26 @@ namespace log4cxx
 
 		*/
 		virtual void append(const spi::LoggingEvent& event);
+
+		/**
+		Write all the events of the batch with #subAppend, then
+		flush the output stream once if the <b>ImmediateFlush</b>
+		option is set.
+		*/
+		virtual void appendBatch(const spi::LoggingEventList& events);
+
+		/**
+		Format the event with the layout, without holding the appender
+		lock. Returns <code>false</code> if there is no layout, so that
+		#append reports the error.
+		*/
+		virtual bool prepare(const spi::LoggingEvent& event, tstring& output);
+
+		/**
+		Write the text formatted by #prepare with #subAppend.
+		*/
+		virtual void commit(const spi::LoggingEvent& event,
+			const tstring& formatted);
 	
 	protected:
 		/**
@@ -144,6 +164,15 @@ namespace log4cxx
 		override this method.
 		*/
 		virtual void subAppend(const spi::LoggingEvent& event);
+
+		/**
+		Write an event already formatted by the layout. This is the
+		method called by #commit, subclasses overriding
+		#subAppend(const spi::LoggingEvent&) must override this one
+		too.
+		*/
+		virtual void subAppend(const spi::LoggingEvent& event,
+			const tstring& formatted);
 	
 	/**
 	The WriterAppender requires a layout. Hence, this method returns
@@ -18,6 +18,7 @@
 #define _LOG4CXX_XML_LAYOUT_H
 
 #include <log4cxx/layout.h>
+#include <log4cxx/helpers/iso8601dateformat.h>
 
 namespace log4cxx
 {
@@ -67,6 +68,8 @@ namespace log4cxx
 			// Print no location info by default
 			bool locationInfo; //= false
 
+			helpers::ISO8601DateFormat dateFormat;
+
 		public:
 			XMLLayout();
 			
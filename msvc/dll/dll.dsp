@@ -106,10 +106,22 @@ SOURCE=..\..\src\asyncappender.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\atomic.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\boundedfifo.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\callsite.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\clock.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\consoleappender.cpp
 # End Source File
 # Begin Source File
@@ -151,6 +163,10 @@ SOURCE=..\..\src\domconfigurator.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\duplicatemessagefilter.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\nt\EventLogCategories.mc
 
 !IF  "$(CFG)" == "dll - Win32 Release"
@@ -216,6 +232,10 @@ SOURCE=..\..\src\gnomexmlreader.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\hazardpointer.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\hierarchy.cpp
 # End Source File
 # Begin Source File
@@ -248,6 +268,10 @@ SOURCE=..\..\src\loggingevent.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\loggingeventpool.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\loglog.cpp
 # End Source File
 # Begin Source File
@@ -256,10 +280,22 @@ SOURCE=..\..\src\logmanager.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\mappedfileappender.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\mdc.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\msxmlreader.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\multistringmatchfilter.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\ndc.cpp
 # End Source File
 # Begin Source File
@@ -292,6 +328,18 @@ SOURCE=..\..\src\patternparser.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\ratelimitfilter.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\relativetimedateformat.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\ringbuffer.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\rollingfileappender.cpp
 # End Source File
 # Begin Source File
@@ -356,6 +404,10 @@ SOURCE=..\..\src\thread.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\threadidentity.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\threadspecificdata.cpp
 # End Source File
 # Begin Source File
@@ -391,10 +443,18 @@ SOURCE=..\..\include\log4cxx\helpers\appenderattachableimpl.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\log4cxx\helpers\atomic.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\helpers\boundedfifo.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\log4cxx\helpers\clock.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\helpers\criticalsection.h
 # End Source File
 # Begin Source File
@@ -423,6 +483,10 @@ SOURCE=..\..\include\log4cxx\helpers\gnomexmlreader.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\log4cxx\helpers\hazardpointer.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\helpers\inetaddress.h
 # End Source File
 # Begin Source File
@@ -431,6 +495,10 @@ SOURCE=..\..\include\log4cxx\helpers\iso8601dateformat.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\log4cxx\helpers\loggingeventpool.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\helpers\loglog.h
 # End Source File
 # Begin Source File
@@ -471,6 +539,10 @@ SOURCE=..\..\include\log4cxx\helpers\relativetimedateformat.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\log4cxx\helpers\ringbuffer.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\helpers\semaphore.h
 # End Source File
 # Begin Source File
@@ -507,6 +579,10 @@ SOURCE=..\..\include\log4cxx\helpers\thread.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\log4cxx\helpers\threadidentity.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\helpers\threadspecificdata.h
 # End Source File
 # Begin Source File
@@ -523,6 +599,10 @@ SOURCE=..\..\include\log4cxx\spi\appenderattachable.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\log4cxx\spi\callsite.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\spi\defaultrepositoryselector.h
 # End Source File
 # Begin Source File
@@ -603,6 +683,10 @@ SOURCE=..\..\include\log4cxx\varia\denyallfilter.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\log4cxx\varia\duplicatemessagefilter.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\varia\levelmatchfilter.h
 # End Source File
 # Begin Source File
@@ -611,6 +695,14 @@ SOURCE=..\..\include\log4cxx\varia\levelrangefilter.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\log4cxx\varia\multistringmatchfilter.h
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\include\log4cxx\varia\ratelimitfilter.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\varia\stringmatchfilter.h
 # End Source File
 # End Group
@@ -676,6 +768,14 @@ SOURCE=..\..\include\log4cxx\logmanager.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\log4cxx\mappedfileappender.h
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\include\log4cxx\mdc.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\log4cxx\ndc.h
 # End Source File
 # Begin Source File
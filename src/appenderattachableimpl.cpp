@@ -17,43 +17,116 @@
 #include <log4cxx/helpers/tchar.h>
 #include <log4cxx/appender.h>
 #include <log4cxx/helpers/appenderattachableimpl.h>
+#include <log4cxx/helpers/atomic.h>
+#include <log4cxx/helpers/hazardpointer.h>
 #include <log4cxx/spi/loggingevent.h>
 #include <algorithm>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 using namespace log4cxx::spi;
- 
+
+struct AppenderAttachableImpl::AppenderArray
+{
+	AppenderArray()
+	{
+	}
+
+	AppenderArray(const AppenderList& appenders)
+	: appenders(appenders)
+	{
+	}
+
+	AppenderList appenders;
+};
+
+AppenderAttachableImpl::AppenderAttachableImpl()
+: appenders(0)
+{
+}
+
+AppenderAttachableImpl::~AppenderAttachableImpl()
+{
+	delete appenders;
+}
+
+void AppenderAttachableImpl::replaceAppenders(AppenderArray * newAppenders)
+{
+	retiredAppenders.retire((AppenderArray *)Atomic::exchangePointer(
+		(void * volatile *)&appenders, newAppenders));
+}
+
 void AppenderAttachableImpl::addAppender(AppenderPtr newAppender)
 {
 	synchronized sync(this);
-	
-    // Null values for newAppender parameter are strictly forbidden.
-    if(newAppender == 0)
-    {
-        return;
-    }
-
-    AppenderList::iterator it = std::find(
-        appenderList.begin(), appenderList.end(), newAppender);
-
-    if (it == appenderList.end())
-    {
-        appenderList.push_back(newAppender);
-    }
+
+	// Null values for newAppender parameter are strictly forbidden.
+	if(newAppender == 0)
+	{
+		return;
+	}
+
+	AppenderArray * array = (appenders == 0) ?
+		new AppenderArray() : new AppenderArray(appenders->appenders);
+	AppenderList& appenderList = array->appenders;
+
+	AppenderList::iterator it = std::find(
+		appenderList.begin(), appenderList.end(), newAppender);
+
+	if (it == appenderList.end())
+	{
+		appenderList.push_back(newAppender);
+		replaceAppenders(array);
+	}
+	else
+	{
+		delete array;
+	}
 }
 
 int AppenderAttachableImpl::appendLoopOnAppenders(const spi::LoggingEvent& event)
 {
-	synchronized sync(this);
+	// loggers without appenders are common in a hierarchy:
+	// skip them without protecting the array.
+	if (Atomic::getPointer((void * const volatile *)&appenders) == 0)
+	{
+		return 0;
+	}
+
+	// the array is not deleted while the hazard pointer protects it
+	HazardPointer hazard((void * const volatile *)&appenders);
+	AppenderArray * array = (AppenderArray *)hazard.get();
+	if (array == 0)
+	{
+		return 0;
+	}
 
-    AppenderList::iterator it, itEnd = appenderList.end();
-    AppenderPtr appender;
-    for(it = appenderList.begin(); it != itEnd; it++)
-    {
-        appender = *it;
-        appender->doAppend(event);
-    }
+	const AppenderList& appenderList = array->appenders;
+	AppenderList::const_iterator it, itEnd = appenderList.end();
+	for(it = appenderList.begin(); it != itEnd; it++)
+	{
+		(*it)->doAppend(event);
+	}
+
+	return appenderList.size();
+}
+
+int AppenderAttachableImpl::appendLoopOnAppenders(
+	const spi::LoggingEventList& events)
+{
+	HazardPointer hazard((void * const volatile *)&appenders);
+	AppenderArray * array = (AppenderArray *)hazard.get();
+	if (array == 0)
+	{
+		return 0;
+	}
+
+	const AppenderList& appenderList = array->appenders;
+	AppenderList::const_iterator it, itEnd = appenderList.end();
+	for(it = appenderList.begin(); it != itEnd; it++)
+	{
+		(*it)->doAppendBatch(events);
+	}
 
 	return appenderList.size();
 }
@@ -62,18 +135,24 @@ AppenderList AppenderAttachableImpl::getAllAppenders()
 {
 	synchronized sync(this);
 
-    return appenderList;
+	if (appenders == 0)
+	{
+		return AppenderList();
+	}
+
+	return appenders->appenders;
 }
 
 AppenderPtr AppenderAttachableImpl::getAppender(const tstring& name)
 {
 	synchronized sync(this);
 
-	if (name.empty())
+	if (name.empty() || appenders == 0)
 	{
 		return 0;
 	}
 
+	AppenderList& appenderList = appenders->appenders;
 	AppenderList::iterator it, itEnd = appenderList.end();
 	AppenderPtr appender;
 	for(it = appenderList.begin(); it != itEnd; it++)
@@ -92,65 +171,79 @@ bool AppenderAttachableImpl::isAttached(AppenderPtr appender)
 {
 	synchronized sync(this);
 
-	if (appender == 0)
-    {
-        return false;
-    }
+	if (appender == 0 || appenders == 0)
+	{
+		return false;
+	}
 
-    AppenderList::iterator it = std::find(
-        appenderList.begin(), appenderList.end(), appender);
+	AppenderList& appenderList = appenders->appenders;
+	AppenderList::iterator it = std::find(
+		appenderList.begin(), appenderList.end(), appender);
 
-    return it != appenderList.end();
+	return it != appenderList.end();
 }
 
 void AppenderAttachableImpl::removeAllAppenders()
 {
 	synchronized sync(this);
 
-    AppenderList::iterator it, itEnd = appenderList.end();
-    AppenderPtr a;
-    for(it = appenderList.begin(); it != itEnd; it++)
-    {
-        a = *it;
-        a->close();
-    }
-     
-    appenderList.clear();
+	if (appenders == 0)
+	{
+		return;
+	}
+
+	// keep the appenders alive until they are closed
+	AppenderList appenderList = appenders->appenders;
+	replaceAppenders(0);
+
+	AppenderList::iterator it, itEnd = appenderList.end();
+	AppenderPtr a;
+	for(it = appenderList.begin(); it != itEnd; it++)
+	{
+		a = *it;
+		a->close();
+	}
 }
 
 void AppenderAttachableImpl::removeAppender(AppenderPtr appender)
 {
 	synchronized sync(this);
 
-    if (appender == 0)
-        return;
-        
-    AppenderList::iterator it = std::find(
-        appenderList.begin(), appenderList.end(), appender);
+	if (appender == 0 || appenders == 0)
+	{
+		return;
+	}
 
-    if (it != appenderList.end())
-    {
-        appenderList.erase(it);
-    }
+	AppenderList appenderList = appenders->appenders;
+	AppenderList::iterator it = std::find(
+		appenderList.begin(), appenderList.end(), appender);
+
+	if (it != appenderList.end())
+	{
+		appenderList.erase(it);
+		replaceAppenders(appenderList.empty() ?
+			0 : new AppenderArray(appenderList));
+	}
 }
 
 void AppenderAttachableImpl::removeAppender(const tstring& name)
 {
 	synchronized sync(this);
 
-	if (name.empty())
+	if (name.empty() || appenders == 0)
 	{
 		return;
 	}
 
+	AppenderList appenderList = appenders->appenders;
 	AppenderList::iterator it, itEnd = appenderList.end();
-	AppenderPtr appender;
 	for(it = appenderList.begin(); it != itEnd; it++)
 	{
-		appender = *it;
-		if(name == appender->getName())
+		if(name == (*it)->getName())
 		{
 			appenderList.erase(it);
+			replaceAppenders(appenderList.empty() ?
+				0 : new AppenderArray(appenderList));
 			return;
 		}
 	}
@@ -19,16 +19,89 @@
 #include <log4cxx/appenderskeleton.h>
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/helpers/onlyonceerrorhandler.h>
+#include <log4cxx/helpers/atomic.h>
 #include <log4cxx/level.h>
+#include <vector>
 
 using namespace log4cxx;
 using namespace log4cxx::spi;
 using namespace log4cxx::helpers;
 
+namespace
+{
+	void deleteBuffer(void * data)
+	{
+		delete (tstring *)data;
+	}
+}
+
+ThreadSpecificData AppenderSkeleton::formatBuffer(deleteBuffer);
+
+volatile long AppenderSkeleton::thresholdGeneration = 0;
+
+int AppenderSkeleton::BUF_SIZE = 256;
+int AppenderSkeleton::MAX_CAPACITY = 1024;
+
+namespace
+{
+	const Level * const compiledLevels[] =
+	{
+		&Level::ALL, &Level::DEBUG, &Level::INFO, &Level::WARN,
+		&Level::ERROR, &Level::FATAL, &Level::OFF
+	};
+
+	const int COMPILED_LEVEL_COUNT =
+		sizeof(compiledLevels) / sizeof(compiledLevels[0]);
+
+	/** Index of level in compiledLevels, or -1. */
+	inline int getCompiledLevel(int level)
+	{
+		switch(level)
+		{
+		case Level::ALL_INT: return 0;
+		case Level::DEBUG_INT: return 1;
+		case Level::INFO_INT: return 2;
+		case Level::WARN_INT: return 3;
+		case Level::ERROR_INT: return 4;
+		case Level::FATAL_INT: return 5;
+		case Level::OFF_INT: return 6;
+		default: return -1;
+		}
+	}
+}
+
+/**
+For each predefined level, the filters which remain to be called, and
+the decision when all of them are neutral.
+*/
+struct AppenderSkeleton::CompiledFilters
+{
+	/** The whole chain, which keeps the filters alive while the
+	table is in use. */
+	std::vector<FilterPtr> chain;
+	std::vector<Filter *> filters[COMPILED_LEVEL_COUNT];
+	bool accepted[COMPILED_LEVEL_COUNT];
+};
+
 AppenderSkeleton::AppenderSkeleton()
-: errorHandler(new OnlyOnceErrorHandler()), closed(false),
-threshold(&Level::ALL)
+: threshold(&Level::ALL), errorHandler(new OnlyOnceErrorHandler()),
+compiledFilters(0), closed(false)
+{
+}
+
+AppenderSkeleton::~AppenderSkeleton()
+{
+	delete compiledFilters;
+}
+
+void AppenderSkeleton::activateOptions()
 {
+	for(Filter * f = headFilter; f != 0; f = f->next)
+	{
+		f->setOwner(this);
+	}
+
+	compileFilters();
 }
 
 void AppenderSkeleton::finalize()
@@ -54,22 +127,89 @@ void AppenderSkeleton::addFilter(spi::FilterPtr newFilter)
 		tailFilter->next = newFilter;
 		tailFilter = newFilter;
 	}
+
+	newFilter->setOwner(this);
+	compileFilters();
 }
 
 void AppenderSkeleton::clearFilters()
 {
+	closeFilters();
 	headFilter = tailFilter = 0;
+	compileFilters();
+}
+
+void AppenderSkeleton::closeFilters()
+{
+	for(Filter * f = headFilter; f != 0; f = f->next)
+	{
+		f->flush();
+		f->setOwner(0);
+	}
+}
+
+void AppenderSkeleton::compileFilters()
+{
+	CompiledFilters * compiled = 0;
+
+	if(headFilter != 0)
+	{
+		compiled = new CompiledFilters;
+
+		for(Filter * f = headFilter; f != 0; f = f->next)
+		{
+			compiled->chain.push_back(f);
+		}
+
+		for(int i = 0; i < COMPILED_LEVEL_COUNT; i++)
+		{
+			const Level& level = *compiledLevels[i];
+			int decision = Filter::NEUTRAL;
+
+			for(Filter * f = headFilter; f != 0; f = f->next)
+			{
+				if(!f->isLevelFilter())
+				{
+					compiled->filters[i].push_back(f);
+					continue;
+				}
+
+				decision = f->decideLevel(level);
+				if(decision != Filter::NEUTRAL)
+				{
+					break;
+				}
+			}
+
+			compiled->accepted[i] = (decision != Filter::DENY);
+		}
+	}
+
+	// lock free readers may still walk the previous table
+	retiredFilters.retire((CompiledFilters *)Atomic::exchangePointer(
+		(void * volatile *)&compiledFilters, compiled));
+}
+
+void AppenderSkeleton::setLayout(LayoutPtr layout)
+{
+	synchronized sync(this);
+	this->layout = layout;
+}
+
+void AppenderSkeleton::setThreshold(const Level& threshold)
+{
+	Atomic::setPointer((void * volatile *)&this->threshold,
+		(void *)&threshold);
+	Atomic::increment(&thresholdGeneration);
 }
 
 bool AppenderSkeleton::isAsSevereAsThreshold(const Level& level)
 {
-	return level.isGreaterOrEqual(*threshold);
+	return level.isGreaterOrEqual(getThreshold());
 }
 
 void AppenderSkeleton::doAppend(const spi::LoggingEvent& event)
 {
-	synchronized sync(this);
-	
 	if(closed)
 	{
 		LogLog::error(_T("Attempted to append to closed appender named [")
@@ -77,29 +217,158 @@ void AppenderSkeleton::doAppend(const spi::LoggingEvent& event)
 		return;
 	}
 
-	if(!isAsSevereAsThreshold(event.getLevel()))
+	if(!isAccepted(event))
+	{
+		return;
+	}
+
+	// The buffer is detached from the thread while in use, in case
+	// formatting or writing the event logs to another appender.
+	tstring * buf = (tstring *)formatBuffer.GetData();
+	if(buf == 0)
+	{
+		buf = new tstring;
+		buf->reserve(BUF_SIZE);
+	}
+	else
+	{
+		formatBuffer.SetData(0);
+	}
+
+	try
+	{
+		buf->erase();
+		bool prepared = prepare(event, *buf);
+
+		synchronized sync(this);
+
+		if(closed)
+		{
+			LogLog::error(_T("Attempted to append to closed appender named [")
+				+name+_T("]."));
+		}
+		else if(prepared)
+		{
+			commit(event, *buf);
+		}
+		else
+		{
+			append(event);
+		}
+	}
+	catch(...)
+	{
+		delete buf;
+		throw;
+	}
+
+	// do not keep the memory of an exceptionally large event
+	if(formatBuffer.GetData() != 0 || (int)buf->capacity() > MAX_CAPACITY)
+	{
+		delete buf;
+	}
+	else
+	{
+		formatBuffer.SetData(buf);
+	}
+}
+
+void AppenderSkeleton::doAppendBatch(const spi::LoggingEventList& events)
+{
+	if(closed)
+	{
+		LogLog::error(_T("Attempted to append to closed appender named [")
+			+name+_T("]."));
+		return;
+	}
+
+	// filtered without holding the lock, a filter may log
+	LoggingEventList accepted;
+	accepted.reserve(events.size());
+
+	LoggingEventList::const_iterator it, itEnd = events.end();
+	for(it = events.begin(); it != itEnd; it++)
+	{
+		if(isAccepted(**it))
+		{
+			accepted.push_back(*it);
+		}
+	}
+
+	if(accepted.empty())
 	{
 		return;
 	}
 
-	FilterPtr f = headFilter;
+	synchronized sync(this);
 
+	if(closed)
+	{
+		return;
+	}
+
+	appendBatch(accepted);
+}
+
+void AppenderSkeleton::appendBatch(const spi::LoggingEventList& events)
+{
+	LoggingEventList::const_iterator it, itEnd = events.end();
+	for(it = events.begin(); it != itEnd; it++)
+	{
+		append(**it);
+	}
+}
+
+bool AppenderSkeleton::isAccepted(const spi::LoggingEvent& event)
+{
+	if(!isAsSevereAsThreshold(event.getLevel()))
+	{
+		return false;
+	}
+
+	HazardPointer hazard((void * const volatile *)&compiledFilters);
+	CompiledFilters * compiled = (CompiledFilters *)hazard.get();
+	if(compiled == 0)
+	{
+		return true;
+	}
+
+	// the filters are borrowed, the table keeps them alive
+	int compiledLevel = getCompiledLevel(event.getLevel().level);
+	if(compiledLevel >= 0)
+	{
+		const std::vector<Filter *>& filters =
+			compiled->filters[compiledLevel];
+
+		std::vector<Filter *>::const_iterator it, itEnd = filters.end();
+		for(it = filters.begin(); it != itEnd; it++)
+		{
+			switch((*it)->decide(event))
+			{
+				case Filter::DENY:
+					return false;
+				case Filter::ACCEPT:
+					return true;
+			}
+		}
+
+		return compiled->accepted[compiledLevel];
+	}
 
-	while(f != 0)
+	// a level defined by the application walks the whole chain
+	std::vector<FilterPtr>::const_iterator it, itEnd = compiled->chain.end();
+	for(it = compiled->chain.begin(); it != itEnd; it++)
 	{
-		 switch(f->decide(event))
-		 {
-			 case Filter::DENY:
-				 return;
-			 case Filter::ACCEPT:
-				 f = 0;
-				 break;
-			 case Filter::NEUTRAL:
-				 f = f->next;
-		 }
+		switch((*it)->decide(event))
+		{
+			case Filter::DENY:
+				return false;
+			case Filter::ACCEPT:
+				return true;
+		}
 	}
 
-	append(event);
+	return true;
 }
 
 void AppenderSkeleton::setErrorHandler(spi::ErrorHandlerPtr errorHandler)
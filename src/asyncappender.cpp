@@ -17,6 +17,12 @@
 #include <log4cxx/asyncappender.h>
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/helpers/boundedfifo.h>
+#include <log4cxx/helpers/ringbuffer.h>
+#include <log4cxx/helpers/atomic.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -25,13 +31,17 @@ using namespace log4cxx::spi;
 /** The default buffer size is set to 128 events. */
 int AsyncAppender::DEFAULT_BUFFER_SIZE = 128;
 
+/** The default summary interval is set to 10 seconds. */
+long AsyncAppender::DEFAULT_SUMMARY_INTERVAL = 10;
+
 AsyncAppender::AsyncAppender()
-: locationInfo(false), interruptedWarningMessage(false)
+: dispatcher(0), locationInfo(false), interruptedWarningMessage(false),
+lockFree(false), overflowPolicy(BLOCK), discardThreshold(&Level::WARN),
+summaryInterval(DEFAULT_SUMMARY_INTERVAL), discardedCount(0),
+pendingDiscarded(0), discardedMaxLevel(Level::ALL_INT), lastSummary(0),
+producersWaiting(0)
 {
 	bf = new BoundedFIFO(DEFAULT_BUFFER_SIZE);
-	
-	dispatcher = new Dispatcher(bf, this);
-	dispatcher->start();
 }
 
 AsyncAppender::~AsyncAppender()
@@ -39,11 +49,168 @@ AsyncAppender::~AsyncAppender()
 	finalize();
 }
 
+void AsyncAppender::setOption(const tstring& option, const tstring& value)
+{
+	if (StringHelper::equalsIgnoreCase(option, _T("buffersize")))
+	{
+		setBufferSize(OptionConverter::toInt(value, DEFAULT_BUFFER_SIZE));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, _T("locationinfo")))
+	{
+		setLocationInfo(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, _T("lockfree")))
+	{
+		setLockFree(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, _T("overflowpolicy")))
+	{
+		if (StringHelper::equalsIgnoreCase(value, _T("block")))
+		{
+			setOverflowPolicy(BLOCK);
+		}
+		else if (StringHelper::equalsIgnoreCase(value, _T("dropnewest")))
+		{
+			setOverflowPolicy(DROP_NEWEST);
+		}
+		else if (StringHelper::equalsIgnoreCase(value, _T("dropoldest")))
+		{
+			setOverflowPolicy(DROP_OLDEST);
+		}
+		else if (StringHelper::equalsIgnoreCase(value, _T("discardbelowlevel")))
+		{
+			setOverflowPolicy(DISCARD_BELOW_LEVEL);
+		}
+		else
+		{
+			LogLog::warn(_T("Unknown overflow policy [") + value
+				+ _T("] for AsyncAppender [") + name + _T("]."));
+		}
+	}
+	else if (StringHelper::equalsIgnoreCase(option, _T("discardthreshold")))
+	{
+		setDiscardThreshold(Level::toLevel(value, Level::WARN));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, _T("summaryinterval")))
+	{
+		setSummaryInterval(
+			OptionConverter::toInt(value, DEFAULT_SUMMARY_INTERVAL));
+	}
+	else
+	{
+		AppenderSkeleton::setOption(option, value);
+	}
+}
+
+void AsyncAppender::activateOptions()
+{
+	AppenderSkeleton::activateOptions();
+
+	synchronized sync(this);
+
+	if (dispatcher == 0 && !closed)
+	{
+		startDispatcher();
+	}
+}
+
+void AsyncAppender::startDispatcher()
+{
+	Dispatcher * newDispatcher;
+
+	// looked up here rather than in the dispatcher thread, which may
+	// still run while the repository is destroyed at exit.
+	summaryLogger = Logger::getLogger(_T("log4cxx.AsyncAppender"));
+
+	if (lockFree)
+	{
+		rb = new RingBuffer(bf->getMaxSize());
+		newDispatcher = new Dispatcher(rb, this);
+	}
+	else
+	{
+		// the dispatcher may hold a full batch while the buffer fills
+		synchronized sync(bf);
+		pool.reserve(2 * bf->getMaxSize());
+		newDispatcher = new Dispatcher(bf, this);
+	}
+
+	newDispatcher->start();
+
+	// publish the dispatcher after the buffer, the lock-free path of
+	// doAppend reads it without holding the appender lock.
+	Atomic::setPointer((void * volatile *)&dispatcher, newDispatcher);
+}
+
+void AsyncAppender::doAppend(const spi::LoggingEvent& event)
+{
+	if (lockFree)
+	{
+		if (Atomic::getPointer((void * const volatile *)&dispatcher) == 0)
+		{
+			synchronized sync(this);
+
+			if (!closed && dispatcher == 0)
+			{
+				startDispatcher();
+			}
+		}
+
+		if(closed)
+		{
+			LogLog::error(_T("Attempted to append to closed appender named [")
+				+name+_T("]."));
+			return;
+		}
+
+		if (!isAccepted(event))
+		{
+			return;
+		}
+	}
+	else
+	{
+		// filtered without holding the lock, a filter may log
+		if (!isAccepted(event))
+		{
+			return;
+		}
+
+		synchronized sync(this);
+
+		if(closed)
+		{
+			LogLog::error(_T("Attempted to append to closed appender named [")
+				+name+_T("]."));
+			return;
+		}
+
+		if (dispatcher == 0)
+		{
+			startDispatcher();
+		}
+	}
+
+	// The event is queued without holding the appender lock: the
+	// dispatcher takes it to call the attached appenders, a producer
+	// waiting for free space would otherwise never be released.
+	append(event);
+}
+
+void AsyncAppender::doAppendBatch(const spi::LoggingEventList& events)
+{
+	// events are queued one by one, without holding the appender lock
+	LoggingEventList::const_iterator it, itEnd = events.end();
+	for(it = events.begin(); it != itEnd; it++)
+	{
+		doAppend(**it);
+	}
+}
+
 void AsyncAppender::append(const spi::LoggingEvent& event)
 {
-	// Set the NDC and thread name for the calling thread as these
-	// LoggingEvent fields were not set at event creation time.
-	event.getNDC();
+	// The NDC frame was captured at event creation time, the queued
+	// copy shares it.
 	// Get a copy of this thread's MDC.
 	event.getMDCCopy();
 	
@@ -51,26 +218,158 @@ void AsyncAppender::append(const spi::LoggingEvent& event)
 	{
 		event.getLocationInformation();
 	}*/
-	
-	synchronized sync(bf);
 
-	while(bf->isFull())
+	if (rb != 0)
 	{
-		//LOGLOG_DEBUG(_T("Waiting for free space in buffer, ")
-		//	 << bf->length());
-		bf->wait();
+		if (rb->offer(event))
+		{
+			return;
+		}
+
+		switch(overflowPolicy)
+		{
+		case DROP_NEWEST:
+			discard(event);
+			break;
+
+		case DROP_OLDEST:
+			while(!rb->offer(event))
+			{
+				// no event can be evicted while the dispatcher copies
+				// the one in the slot the new event goes to, it
+				// releases the slot right after
+				LoggingEvent * oldest = rb->evict();
+				if (oldest != 0)
+				{
+					discard(*oldest);
+					rb->release(oldest);
+				}
+			}
+			break;
+
+		case DISCARD_BELOW_LEVEL:
+			if (!event.getLevel().isGreaterOrEqual(*discardThreshold))
+			{
+				discard(event);
+				break;
+			}
+			rb->put(event);
+			break;
+
+		default:
+			rb->put(event);
+			break;
+		}
+
+		return;
 	}
-	
-	bf->put(event.copy());
-	if(bf->wasEmpty())
+
+	bool waiting = false;
+
+	while(true)
 	{
-		//LogLog::debug(_T("Notifying dispatcher to process events."));
-		bf->notify();
+		{
+			synchronized sync(bf);
+
+			if (waiting)
+			{
+				producersWaiting--;
+				waiting = false;
+			}
+
+			if (!bf->isFull())
+			{
+				bf->put(pool.acquire(event));
+				if(bf->wasEmpty())
+				{
+					//LogLog::debug(_T("Notifying dispatcher to process events."));
+					bf->notify();
+				}
+				return;
+			}
+
+			switch(overflowPolicy)
+			{
+			case DROP_NEWEST:
+				discard(event);
+				return;
+
+			case DROP_OLDEST:
+				{
+					LoggingEvent * oldest = bf->get();
+					discard(*oldest);
+					pool.release(oldest);
+					bf->put(pool.acquire(event));
+				}
+				return;
+
+			case DISCARD_BELOW_LEVEL:
+				if (!event.getLevel().isGreaterOrEqual(*discardThreshold))
+				{
+					discard(event);
+					return;
+				}
+				break;
+			}
+
+			//LOGLOG_DEBUG(_T("Waiting for free space in buffer, ")
+			//	 << bf->length());
+			producersWaiting++;
+			waiting = true;
+		} // synchronized
+
+		notFull.wait();
+	}
+}
+
+void AsyncAppender::discard(const spi::LoggingEvent& event)
+{
+	Atomic::increment(&discardedCount);
+	Atomic::increment(&pendingDiscarded);
+
+	long level = event.getLevel().toInt();
+	long maxLevel = Atomic::get(&discardedMaxLevel);
+	while (level > maxLevel
+		&& !Atomic::compareAndSet(&discardedMaxLevel, maxLevel, level))
+	{
+		maxLevel = Atomic::get(&discardedMaxLevel);
+	}
+}
+
+void AsyncAppender::appendSummary(bool force)
+{
+	if (Atomic::get(&pendingDiscarded) == 0)
+	{
+		return;
+	}
+
+	time_t now = time(0);
+	if (!force && now - lastSummary < summaryInterval)
+	{
+		return;
 	}
+
+	lastSummary = now;
+	long count = Atomic::exchange(&pendingDiscarded, 0);
+	long maxLevel = Atomic::exchange(&discardedMaxLevel, Level::ALL_INT);
+
+	// report at WARN level, or higher if more severe events were lost
+	const Level& level = maxLevel > Level::WARN_INT ?
+		Level::toLevel(maxLevel, Level::WARN) : Level::WARN;
+
+	tostringstream oss;
+	oss << _T("AsyncAppender [") << name << _T("] discarded ") << count
+		<< (count == 1 ? _T(" event.") : _T(" events."));
+
+	LoggingEvent summary(summaryLogger, level, oss.str());
+	appendLoopOnAppenders(summary);
 }
 
 void AsyncAppender::close()
 {
+	// the filters append what they hold back while the appender is open
+	closeFilters();
+
 	{
 		synchronized sync(this);
 		// avoid multiple close, otherwise one gets NullPointerException
@@ -81,37 +380,114 @@ void AsyncAppender::close()
 		
 		closed = true;
 	}
-	
+
+	if (dispatcher == 0)
+	{
+		// no event was ever appended, the dispatcher was not started
+		removeAllAppenders();
+		return;
+	}
+
 	// The following cannot be synchronized on "this" because the
 	// dispatcher synchronizes with "this" in its while loop. If we
 	// did synchronize we would systematically get deadlocks when
 	// close was called.
 	dispatcher->close();
-	
-	dispatcher->join();
+
+	// The dispatcher thread deletes its Thread object when run returns,
+	// so it cannot be joined: wait for the end of run instead.
+	dispatcherEnded.wait();
 	dispatcher = 0;
-	bf = 0;
 }
 
 void AsyncAppender::setBufferSize(int size)
 {
+	if (rb != 0)
+	{
+		LogLog::warn(_T("The buffer size of the lock-free AsyncAppender [")
+			+ name + _T("] cannot be changed once it is started."));
+		return;
+	}
+
+	if (size < 1)
+	{
+		LogLog::warn(_T("The buffer size of AsyncAppender [") + name
+			+ _T("] must be a positive integer."));
+		return;
+	}
+
+	synchronized sync(bf);
+
+	// the oldest events which no longer fit are discarded, their copies
+	// go back to the pool
+	while (bf->length() > size)
+	{
+		LoggingEvent * oldest = bf->get();
+		discard(*oldest);
+		pool.release(oldest);
+	}
+
 	bf->resize(size);
+
+	// the dispatcher may hold a full batch while the buffer fills
+	pool.trim(2 * size);
+
+	// producers may be waiting for the new free space
+	for (int i = 0; i < producersWaiting; i++)
+	{
+		notFull.post();
+	}
 }
 
 int AsyncAppender::getBufferSize()
 {
-	return bf->getMaxSize();
+	return rb != 0 ? rb->getMaxSize() : bf->getMaxSize();
+}
+
+void AsyncAppender::setLockFree(bool lockFree)
+{
+	synchronized sync(this);
+
+	if (dispatcher != 0)
+	{
+		LogLog::warn(_T("The LockFree option of AsyncAppender [")
+			+ name + _T("] cannot be changed once it is started."));
+		return;
+	}
+
+	this->lockFree = lockFree;
 }
 
 Dispatcher::Dispatcher(helpers::BoundedFIFOPtr bf, AsyncAppender * container)
- : bf(bf), container(container), interrupted(false)
+ : bf(bf), interrupted(false), container(container), copies(0)
 {
 	// set the dispatcher priority to lowest possible value
 	setPriority(Thread::MIN_PRIORITY);
 }
+
+Dispatcher::Dispatcher(helpers::RingBufferPtr rb, AsyncAppender * container)
+ : rb(rb), interrupted(false), container(container),
+ copies(new LoggingEvent[rb->getMaxSize()])
+{
+	// set the dispatcher priority to lowest possible value
+	setPriority(Thread::MIN_PRIORITY);
+}
+
+Dispatcher::~Dispatcher()
+{
+	delete [] copies;
+}
 	
 void Dispatcher::close()
 {
+	if (rb != 0)
+	{
+		interrupted = true;
+		Atomic::memoryBarrier();
+		rb->wakeUp();
+		return;
+	}
+
 	synchronized sync(bf);
 
 	interrupted = true;
@@ -125,7 +501,14 @@ void Dispatcher::close()
 
 void Dispatcher::run()
 {
+	if (rb != 0)
+	{
+		runRingBuffer();
+		return;
+	}
+
 	LoggingEvent * event;
+	LoggingEventList::iterator it;
 
 	while(true)
 	{
@@ -140,23 +523,96 @@ void Dispatcher::run()
 				{
 					break;
 				}
-				bf->wait();
 			}
-			
-			event = bf->get();
-			if(bf->wasFull())
+			else
 			{
-				bf->notify();
+				// take the whole backlog at once
+				while((event = bf->get()) != 0)
+				{
+					batch.push_back(event);
+				}
+
+				for(int i = 0; i < container->producersWaiting; i++)
+				{
+					container->notFull.post();
+				}
 			}
 		} // synchronized
 
-		if(event != 0)
+		if(!batch.empty())
 		{
-			container->appendLoopOnAppenders(*event);
-			delete event;
+			container->appendLoopOnAppenders(batch);
+
+			{
+				synchronized sync(bf);
+				for(it = batch.begin(); it != batch.end(); it++)
+				{
+					container->pool.release(*it);
+				}
+			}
+			batch.clear();
+			container->appendSummary(false);
+		}
+		else
+		{
+			container->appendSummary(false);
+			bf->wait();
+		}
+	} // while
+
+	// report the events discarded since the last summary
+	container->appendSummary(true);
+
+	// close and remove all appenders
+	container->removeAllAppenders();
+	container->dispatcherEnded.post();
+}
+
+void Dispatcher::runRingBuffer()
+{
+	LoggingEvent * event;
+	int maxBatchSize = rb->getMaxSize();
+
+	while(true)
+	{
+		// the slots are released as soon as their events are copied,
+		// the copies keep the storage of their strings between batches
+		while((int)batch.size() < maxBatchSize
+			&& (event = rb->get()) != 0)
+		{
+			LoggingEvent * copy = &copies[batch.size()];
+			*copy = *event;
+			rb->release(event);
+			batch.push_back(copy);
+		}
+
+		if(!batch.empty())
+		{
+			container->appendLoopOnAppenders(batch);
+			batch.clear();
+			container->appendSummary(false);
+		}
+		else if(interrupted)
+		{
+			// Exit loop if interrupted but only if
+			// the buffer is empty.
+			Atomic::memoryBarrier();
+			if(rb->isEmpty())
+			{
+				break;
+			}
+		}
+		else
+		{
+			container->appendSummary(false);
+			rb->await();
 		}
 	} // while
 
+	// report the events discarded since the last summary
+	container->appendSummary(true);
+
 	// close and remove all appenders
 	container->removeAllAppenders();
+	container->dispatcherEnded.post();
 }
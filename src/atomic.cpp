@@ -0,0 +1,31 @@
+/***************************************************************************
+                          atomic.cpp  -  class Atomic
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/helpers/atomic.h>
+
+#ifdef LOG4CXX_ATOMIC_LOCKED
+using namespace log4cxx::helpers;
+
+CriticalSection& Atomic::getLock()
+{
+	// created by the first operation, which may run during the static
+	// initialization of another file
+	static CriticalSection lock;
+	return lock;
+}
+
+CriticalSection& Atomic::initialLock = Atomic::getLock();
+#endif
@@ -17,11 +17,13 @@
 #include <log4cxx/helpers/boundedfifo.h>
 #include <log4cxx/spi/loggingevent.h>
 #include <log4cxx/helpers/exception.h>
+#include <string.h>
 
 using namespace log4cxx::helpers;
 using namespace log4cxx::spi;
 
-BoundedFIFO::BoundedFIFO(int maxSize) : numElements(0), first(0), next(0)
+BoundedFIFO::BoundedFIFO(int maxSize)
+: numElements(0), first(0), next(0), maxSize(maxSize)
 {
 	if(maxSize < 1)
 	{
@@ -33,6 +35,17 @@ BoundedFIFO::BoundedFIFO(int maxSize) : numElements(0), first(0), next(0)
 	buf = new LoggingEvent *[maxSize];
 }
 
+BoundedFIFO::~BoundedFIFO()
+{
+	LoggingEvent * event;
+	while((event = get()) != 0)
+	{
+		delete event;
+	}
+
+	delete [] buf;
+}
+
 LoggingEvent * BoundedFIFO::get()
 {
 	if(numElements == 0)
@@ -67,8 +80,6 @@ void BoundedFIFO::put(log4cxx::spi::LoggingEvent * o)
 
 void BoundedFIFO::resize(int newSize)
 {
-	synchronized sync(this);
-	
 	if(newSize == maxSize)
 	{
 		return;
@@ -96,9 +107,16 @@ void BoundedFIFO::resize(int newSize)
 	{
 		len2 = numElements - len1;
 		len2 = min(len2, newSize - len1);
-		memcpy(tmp, buf + len1, len2 * sizeof(LoggingEvent *));
+		memcpy(tmp + len1, buf, len2 * sizeof(LoggingEvent *));
+	}
+
+	// the newest events do not fit
+	for(int i = len1 + len2; i < numElements; i++)
+	{
+		delete buf[(first + i) % maxSize];
 	}
 
+	delete [] buf;
 	this->buf = tmp;
 	this->maxSize = newSize;
 	this->first=0;
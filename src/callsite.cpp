@@ -0,0 +1,109 @@
+/***************************************************************************
+                          callsite.cpp  -  struct CallSite
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/spi/callsite.h>
+#include <log4cxx/helpers/atomic.h>
+
+using namespace log4cxx;
+using namespace log4cxx::spi;
+using namespace log4cxx::helpers;
+
+namespace
+{
+	/** Convert text to TCHAR once and publish it in cache. */
+	const TCHAR * cacheText(const char * text, const TCHAR * volatile * cache)
+	{
+		const TCHAR * cached = (const TCHAR *)Atomic::getPointer(
+			(void * const volatile *)cache);
+		if (cached != 0 || text == 0)
+		{
+			return cached;
+		}
+
+#ifdef UNICODE
+		USES_CONVERSION;
+		const TCHAR * converted = A2T(text);
+		size_t length = std::char_traits<TCHAR>::length(converted);
+		TCHAR * copy = new TCHAR[length + 1];
+		std::char_traits<TCHAR>::copy(copy, converted, length + 1);
+
+		if (!Atomic::compareAndSetPointer((void * volatile *)cache, 0, copy))
+		{
+			delete [] copy;
+		}
+#else
+		Atomic::compareAndSetPointer((void * volatile *)cache, 0,
+			(void *)text);
+#endif
+
+		return (const TCHAR *)Atomic::getPointer(
+			(void * const volatile *)cache);
+	}
+}
+
+const TCHAR * CallSite::getFileName()
+{
+	const TCHAR * name = (const TCHAR *)Atomic::getPointer(
+		(void * const volatile *)&fileName);
+	if (name != 0 || file == 0)
+	{
+		return name;
+	}
+
+	return cacheText(getBaseName(file), &fileName);
+}
+
+const TCHAR * CallSite::getFunctionName()
+{
+	return cacheText(function, &functionName);
+}
+
+long CallSite::getId()
+{
+	long current = Atomic::get(&id);
+	if (current == 0)
+	{
+		// FNV-1a hash of the file name, then of the line
+		unsigned long hash = 2166136261UL;
+		const char * name = (file == 0) ? "" : getBaseName(file);
+		for (const char * p = name; *p != 0; p++)
+		{
+			hash = ((hash ^ (unsigned char)*p) * 16777619UL) & 0xFFFFFFFFUL;
+		}
+
+		hash = ((hash ^ (unsigned long)line) * 16777619UL) & 0x7FFFFFFFUL;
+
+		// 0 means not computed yet
+		current = (hash == 0) ? 1 : (long)hash;
+		Atomic::set(&id, current);
+	}
+
+	return current;
+}
+
+const char * CallSite::getBaseName(const char * path)
+{
+	const char * base = path;
+	for (const char * p = path; *p != 0; p++)
+	{
+		if (*p == '/' || *p == '\\')
+		{
+			base = p + 1;
+		}
+	}
+
+	return base;
+}
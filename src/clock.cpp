@@ -0,0 +1,102 @@
+/***************************************************************************
+                          clock.cpp  -  class Clock
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/helpers/clock.h>
+#include <log4cxx/helpers/atomic.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+using namespace log4cxx::helpers;
+
+volatile long Clock::anchored = 0;
+time_t Clock::offsetSeconds = 0;
+long Clock::offsetMicroseconds = 0;
+
+void Clock::getTime(time_t& seconds, long& microseconds)
+{
+#ifdef WIN32
+	// 100 nanosecond intervals since 01.01.1601
+	FILETIME ft;
+	::GetSystemTimeAsFileTime(&ft);
+	ULARGE_INTEGER t;
+	t.LowPart = ft.dwLowDateTime;
+	t.HighPart = ft.dwHighDateTime;
+	t.QuadPart = (t.QuadPart - 116444736000000000) / 10;
+
+	seconds = (time_t)(t.QuadPart / 1000000);
+	microseconds = (long)(t.QuadPart % 1000000);
+#elif defined(CLOCK_MONOTONIC)
+	if (Atomic::get(&anchored) != 1 && !anchor())
+	{
+		// another thread is anchoring the clock
+		struct timeval tv;
+		::gettimeofday(&tv, 0);
+
+		seconds = tv.tv_sec;
+		microseconds = tv.tv_usec;
+		return;
+	}
+
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	seconds = ts.tv_sec + offsetSeconds;
+	microseconds = ts.tv_nsec / 1000 + offsetMicroseconds;
+	if (microseconds >= 1000000)
+	{
+		microseconds -= 1000000;
+		seconds++;
+	}
+#else
+	struct timeval tv;
+	::gettimeofday(&tv, 0);
+
+	seconds = tv.tv_sec;
+	microseconds = tv.tv_usec;
+#endif
+}
+
+bool Clock::anchor()
+{
+#if !defined(WIN32) && defined(CLOCK_MONOTONIC)
+	if (!Atomic::compareAndSet(&anchored, 0, 2))
+	{
+		return Atomic::get(&anchored) == 1;
+	}
+
+	struct timeval tv;
+	struct timespec ts;
+	::gettimeofday(&tv, 0);
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	time_t s = tv.tv_sec - ts.tv_sec;
+	long us = tv.tv_usec - ts.tv_nsec / 1000;
+	if (us < 0)
+	{
+		us += 1000000;
+		s--;
+	}
+
+	offsetSeconds = s;
+	offsetMicroseconds = us;
+	Atomic::set(&anchored, 1);
+#endif
+	return true;
+}
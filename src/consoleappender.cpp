@@ -83,6 +83,8 @@ void ConsoleAppender::targetWarn(const tstring& val)
 
 void ConsoleAppender::activateOptions()
 {
+	WriterAppender::activateOptions();
+
 	if(StringHelper::equalsIgnoreCase(SYSTEM_OUT, target))
 	{
 		os = &tcout;
@@ -17,6 +17,9 @@
 #include <log4cxx/helpers/dateformat.h>
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/helpers/absolutetimedateformat.h>
+#include <log4cxx/helpers/atomic.h>
+#include <stdexcept>
+#include <string.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -25,47 +28,158 @@ tstring AbsoluteTimeDateFormat::ISO8601_DATE_FORMAT = _T("ISO8601");
 tstring AbsoluteTimeDateFormat::ABS_TIME_DATE_FORMAT = _T("ABSOLUTE");
 tstring AbsoluteTimeDateFormat::DATE_AND_TIME_DATE_FORMAT = _T("DATE");
 
-DateFormat::DateFormat(const tstring& dateFormat, const tstring& timeZone)
- : dateFormat(dateFormat), timeZone(timeZone)
+namespace
 {
+	void appendFraction(tstring& output, long microseconds, int digits)
+	{
+		TCHAR buf[6];
+		long value = (digits == 3) ? microseconds / 1000 : microseconds;
+
+		for (int i = digits - 1; i >= 0; i--)
+		{
+			buf[i] = (TCHAR)(_T('0') + value % 10);
+			value /= 10;
+		}
+
+		output.append(buf, digits);
+	}
 }
 
-void DateFormat::format(tostream& os, time_t time)
+DateFormat::DateFormat(const tstring& dateFormat, const tstring& timeZone)
+ : dateFormat(dateFormat), timeZone(timeZone), fractionDigits(0),
+ cacheSequence(0), cachedTime(0), cachedLength(-1), cachedSplit(0)
 {
-	typedef tostream::char_type char_type;
-	typedef tostream::traits_type traits_type;
-	typedef std::ostreambuf_iterator<char_type, traits_type> iterator_type;
-	typedef std::time_put< char_type, iterator_type > facet_type;
+	if (!timeZone.empty())
+	{
+		try
+		{
+			USES_CONVERSION;
+			locale = std::locale(T2A(timeZone.c_str()));
+		}
+		catch(std::runtime_error&)
+		{
+			LogLog::warn(_T("Unknown locale [") + timeZone +
+				_T("], using the default one."));
+		}
+	}
+
+	// look for the first SSS or SSSSSS run which is not a conversion
+	tstring::size_type len = dateFormat.length();
+	tstring::size_type i = 0;
+	while (i < len)
+	{
+		if (dateFormat[i] == _T('%'))
+		{
+			i += 2;
+			continue;
+		}
+
+		tstring::size_type end = i;
+		while (end < len && dateFormat[end] == _T('S'))
+		{
+			end++;
+		}
+
+		if (end - i == 3 || end - i == 6)
+		{
+			fractionDigits = (int)(end - i);
+			prefixFormat = dateFormat.substr(0, i);
+			suffixFormat = dateFormat.substr(end);
+			return;
+		}
 
-	const tm * tm = gmtime(&time);
+		i = (end > i) ? end : i + 1;
+	}
+
+	prefixFormat = dateFormat;
+}
+
+void DateFormat::format(tostream& os, time_t time, long microseconds)
+{
+	tstring s;
+	format(s, time, microseconds);
+	os.write(s.data(), s.size());
+}
 
-	if (timeZone.empty())
+void DateFormat::format(tstring& output, time_t time, long microseconds)
+{
+	// read the cache without blocking: the copy is only valid if no
+	// writer started in between
+	long seq = Atomic::get(&cacheSequence);
+	if ((seq & 1) == 0 && cachedTime == time && cachedLength >= 0)
 	{
-		std::locale loc = os.getloc();
+		TCHAR text[CACHE_SIZE];
+		int length = cachedLength;
+		int split = cachedSplit;
+		memcpy(text, cachedText, length * sizeof(TCHAR));
+
+		Atomic::memoryBarrier();
+		if (Atomic::get(&cacheSequence) == seq)
+		{
+			output.append(text, split);
+			if (fractionDigits != 0)
+			{
+				appendFraction(output, microseconds, fractionDigits);
+			}
+			output.append(text + split, length - split);
+			return;
+		}
+	}
 
+	struct tm tm;
 #ifdef WIN32
-		const facet_type& facet = std::use_facet<facet_type>(loc, 0, true);
-		 facet.put(os,os,tm,dateFormat.c_str(), dateFormat.c_str() +
-			 dateFormat.size());
+	tm = *gmtime(&time);
 #else
-		const facet_type& facet = std::use_facet<facet_type>(loc);
-		 facet.put(os,os,_T(' '),tm,dateFormat.c_str(), dateFormat.c_str() +
-			 dateFormat.size());
+	gmtime_r(&time, &tm);
 #endif
+
+	tstring text;
+	formatTime(text, tm, prefixFormat);
+	int split = (int)text.length();
+	if (!suffixFormat.empty())
+	{
+		formatTime(text, tm, suffixFormat);
 	}
-	else
+
+	output.append(text, 0, split);
+	if (fractionDigits != 0)
 	{
-		USES_CONVERSION;
-		std::locale loc(T2A(timeZone.c_str()));
+		appendFraction(output, microseconds, fractionDigits);
+	}
+	output.append(text, split, tstring::npos);
+
+	int length = (int)text.length();
+	seq = Atomic::get(&cacheSequence);
+	if (length <= CACHE_SIZE && (seq & 1) == 0
+		&& Atomic::compareAndSet(&cacheSequence, seq, seq + 1))
+	{
+		cachedTime = time;
+		cachedLength = length;
+		cachedSplit = split;
+		text.copy(cachedText, length);
+		Atomic::set(&cacheSequence, seq + 2);
+	}
+}
+
+void DateFormat::formatTime(tstring& output, const struct tm& tm,
+	const tstring& format)
+{
+	typedef tostream::char_type char_type;
+	typedef tostream::traits_type traits_type;
+	typedef std::ostreambuf_iterator<char_type, traits_type> iterator_type;
+	typedef std::time_put< char_type, iterator_type > facet_type;
+
+	tostringstream os;
+	os.imbue(locale);
 
 #ifdef WIN32
-		const facet_type& facet = std::use_facet<facet_type>(loc, 0, true);
-		 facet.put(os,os,tm,dateFormat.c_str(), dateFormat.c_str() +
-			 dateFormat.size());
+	const facet_type& facet = std::use_facet<facet_type>(locale, 0, true);
+	 facet.put(os,os,&tm,format.c_str(), format.c_str() + format.size());
 #else
-		const facet_type& facet = std::use_facet<facet_type>(loc);
-		 facet.put(os,os,_T(' '),tm,dateFormat.c_str(), dateFormat.c_str() +
-			 dateFormat.size());
+	const facet_type& facet = std::use_facet<facet_type>(locale);
+	 facet.put(os,os,_T(' '),&tm,format.c_str(), format.c_str() +
+		 format.size());
 #endif
-	}
+
+	output.append(os.str());
 }
@@ -21,6 +21,7 @@
 #include <log4cxx/consoleappender.h>
 #include <log4cxx/fileappender.h>
 #include <log4cxx/rollingfileappender.h>
+#include <log4cxx/mappedfileappender.h>
 #include <log4cxx/net/socketappender.h>
 #include <log4cxx/net/sockethubappender.h>
 #include <log4cxx/net/telnetappender.h>
@@ -47,7 +48,10 @@ using namespace log4cxx::nt;
 #include <log4cxx/varia/denyallfilter.h>
 #include <log4cxx/varia/levelmatchfilter.h>
 #include <log4cxx/varia/levelrangefilter.h>
+#include <log4cxx/varia/ratelimitfilter.h>
+#include <log4cxx/varia/duplicatemessagefilter.h>
 #include <log4cxx/varia/stringmatchfilter.h>
+#include <log4cxx/varia/multistringmatchfilter.h>
 
 // helpers
 #include <log4cxx/helpers/loglog.h>
@@ -475,6 +479,10 @@ AppenderPtr DOMConfigurator::BuildAppender(const tstring& className)
 	{
 		appender = new RollingFileAppender();
 	}
+	else if (className == _T("mappedfileappender"))
+	{
+		appender = new MappedFileAppender();
+	}
 #ifdef WIN32
 	else if (className == _T("nteventlogappender"))
 	{
@@ -528,6 +536,18 @@ FilterPtr DOMConfigurator::BuildFilter(const tstring& className)
 	{
 		filter = new StringMatchFilter();
 	}
+	else if (className == _T("multistringmatchfilter"))
+	{
+		filter = new MultiStringMatchFilter();
+	}
+	else if (className == _T("ratelimitfilter"))
+	{
+		filter = new RateLimitFilter();
+	}
+	else if (className == _T("duplicatemessagefilter"))
+	{
+		filter = new DuplicateMessageFilter();
+	}
 	else
 	{
 		LogLog::error(_T("Could not create Filter [") +className+ _T("]."));
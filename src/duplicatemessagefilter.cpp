@@ -0,0 +1,255 @@
+/***************************************************************************
+              duplicatemessagefilter.cpp  -  class DuplicateMessageFilter
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/varia/duplicatemessagefilter.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/atomic.h>
+#include <log4cxx/appender.h>
+#include <log4cxx/level.h>
+#include <limits.h>
+
+using namespace log4cxx;
+using namespace log4cxx::varia;
+using namespace log4cxx::spi;
+using namespace log4cxx::helpers;
+
+tstring DuplicateMessageFilter::KEY_OPTION = _T("Key");
+tstring DuplicateMessageFilter::WINDOW_OPTION = _T("Window");
+
+ThreadSpecificData DuplicateMessageFilter::reporting;
+
+DuplicateMessageFilter::DuplicateMessageFilter()
+: keyByLocation(false), window(5000), nextExpiry(LONG_MAX)
+{
+	series = new Series[MAX_SERIES];
+	for (int i = 0; i < MAX_SERIES; i++)
+	{
+		series[i].hash = 0;
+		series[i].level = 0;
+		series[i].callSite = 0;
+		series[i].first = 0;
+		series[i].repeats = 0;
+	}
+}
+
+DuplicateMessageFilter::~DuplicateMessageFilter()
+{
+	delete [] series;
+}
+
+void DuplicateMessageFilter::setOption(const tstring& option,
+	const tstring& value)
+{
+	if (StringHelper::equalsIgnoreCase(option, KEY_OPTION))
+	{
+		keyByLocation =
+			StringHelper::equalsIgnoreCase(value, _T("location"));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, WINDOW_OPTION))
+	{
+		window = OptionConverter::toInt(value, window);
+	}
+}
+
+int DuplicateMessageFilter::decide(const LoggingEvent& event)
+{
+	if (reporting.GetData() == this)
+	{
+		// the summary of this filter
+		return Filter::NEUTRAL;
+	}
+
+	// FNV-1a of the key of the event
+	unsigned long hash = 2166136261UL;
+	hash = (hash ^ (unsigned long)event.getLogger().p) * 16777619UL;
+	hash = (hash ^ (unsigned long)event.getLevel().level) * 16777619UL;
+
+	const tstring& message = event.getRenderedMessage();
+	if (keyByLocation && event.getCallSite() != 0)
+	{
+		hash = (hash ^ (unsigned long)event.getCallSite()) * 16777619UL;
+	}
+	else
+	{
+		tstring::const_iterator it, itEnd = message.end();
+		for (it = message.begin(); it != itEnd; it++)
+		{
+			hash = (hash ^ (unsigned long)*it) * 16777619UL;
+		}
+	}
+
+	// the series which went quiet end at the first event after them
+	long now = event.getRelativeTime();
+	if (now >= Atomic::get(&nextExpiry))
+	{
+		endSeries(now, false);
+	}
+
+	Series& current = series[(hash ^ (hash >> 16)) & (MAX_SERIES - 1)];
+
+	current.cs.lock();
+
+	bool same = current.level != 0 && current.hash == hash &&
+		current.logger == event.getLogger() &&
+		current.level == &event.getLevel() &&
+		(keyByLocation && event.getCallSite() != 0 ?
+			current.callSite == event.getCallSite() :
+			current.message == message);
+
+	if (same && now - current.first < window)
+	{
+		if (current.repeats++ == 0)
+		{
+			setNextExpiry(current.first + window);
+		}
+
+		current.cs.unlock();
+		return Filter::DENY;
+	}
+
+	// the series ends, its summary is logged without the lock
+	LoggerPtr logger;
+	const Level * level = 0;
+	CallSite * callSite = 0;
+	tstring previous;
+	long repeats = current.repeats;
+
+	if (repeats > 0)
+	{
+		logger = current.logger;
+		level = current.level;
+		callSite = current.callSite;
+		previous.swap(current.message);
+	}
+
+	current.hash = hash;
+	current.logger = event.getLogger();
+	current.level = &event.getLevel();
+	current.callSite = event.getCallSite();
+	current.message = message;
+	current.first = now;
+	current.repeats = 0;
+
+	current.cs.unlock();
+
+	if (repeats > 0)
+	{
+		report(logger, *level, callSite, previous, repeats);
+	}
+
+	return Filter::NEUTRAL;
+}
+
+void DuplicateMessageFilter::flush()
+{
+	endSeries(0, true);
+}
+
+void DuplicateMessageFilter::endSeries(long now, bool all)
+{
+	// one thread ends the series, the others go on
+	long expiry = Atomic::exchange(&nextExpiry, LONG_MAX);
+	if (!all && now < expiry)
+	{
+		setNextExpiry(expiry);
+		return;
+	}
+
+	for (int i = 0; i < MAX_SERIES; i++)
+	{
+		Series& current = series[i];
+
+		current.cs.lock();
+
+		if (current.repeats == 0)
+		{
+			current.cs.unlock();
+			continue;
+		}
+
+		if (!all && now - current.first < window)
+		{
+			setNextExpiry(current.first + window);
+			current.cs.unlock();
+			continue;
+		}
+
+		// the next identical event starts a new series
+		LoggerPtr logger = current.logger;
+		const Level * level = current.level;
+		CallSite * callSite = current.callSite;
+		tstring message = current.message;
+		long repeats = current.repeats;
+		current.repeats = 0;
+		current.first = now - window;
+
+		current.cs.unlock();
+
+		report(logger, *level, callSite, message, repeats);
+	}
+}
+
+void DuplicateMessageFilter::setNextExpiry(long expiry)
+{
+	long next = Atomic::get(&nextExpiry);
+	while (expiry < next &&
+		!Atomic::compareAndSet(&nextExpiry, next, expiry))
+	{
+		next = Atomic::get(&nextExpiry);
+	}
+}
+
+void DuplicateMessageFilter::report(const LoggerPtr& logger,
+	const Level& level, CallSite * callSite, const tstring& message,
+	long repeats)
+{
+	Appender * owner = getOwner();
+	if (owner == 0)
+	{
+		return;
+	}
+
+	tostringstream summary;
+	summary << _T("Last message repeated ") << repeats
+		<< (repeats == 1 ? _T(" time: ") : _T(" times: ")) << message;
+
+	// the summary goes through the other filters, not this one
+	void * previous = reporting.GetData();
+	reporting.SetData(this);
+
+	try
+	{
+		if (callSite != 0)
+		{
+			LoggingEvent event(logger, level, summary.str(), *callSite);
+			owner->doAppend(event);
+		}
+		else
+		{
+			LoggingEvent event(logger, level, summary.str());
+			owner->doAppend(event);
+		}
+	}
+	catch(...)
+	{
+		reporting.SetData(previous);
+		throw;
+	}
+
+	reporting.SetData(previous);
+}
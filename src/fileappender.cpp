@@ -18,18 +18,67 @@
 #include <log4cxx/helpers/stringhelper.h>
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/level.h>
+
+#if defined(HAVE_UNISTD_H) && !defined(UNICODE)
+#define LOG4CXX_RAW_IO
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <string.h>
+#ifdef HAVE_WRITEV
+#include <sys/uio.h>
+#endif
+#endif
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace log4cxx
+{
+	class FileAppender::Flusher : public Thread
+	{
+	public:
+		Flusher(FileAppender * appender) : appender(appender)
+		{
+			setPriority(Thread::MIN_PRIORITY);
+		}
+
+		void run()
+		{
+			while(!appender->flusherStop.tryWait(appender->flushInterval))
+			{
+				appender->flushBuffer();
+			}
+
+			appender->flusherEnded.post();
+		}
+
+	protected:
+		FileAppender * appender;
+	};
+};
+
+long FileAppender::DEFAULT_FLUSH_INTERVAL = 1000;
 
 FileAppender::FileAppender()
-: fileAppend(true), bufferedIO(false), bufferSize(8*1024)
+: fileAppend(true), bufferedIO(false), bufferSize(8*1024), buffer(0),
+flushInterval(DEFAULT_FLUSH_INTERVAL), dirty(false), rawIO(false),
+syncPolicy(SYNC_NONE), fd(-1), fileLength(0), pending(0), unsynced(false),
+flusher(0)
 {
 }
 
 FileAppender::FileAppender(LayoutPtr layout, const tstring& fileName,
 	bool append, bool bufferedIO, int bufferSize)
-: fileName(fileName), fileAppend(append), bufferedIO(bufferedIO), bufferSize(bufferSize)
+: fileName(fileName), fileAppend(append), bufferedIO(bufferedIO), bufferSize(bufferSize),
+buffer(0), flushInterval(DEFAULT_FLUSH_INTERVAL), dirty(false), rawIO(false),
+syncPolicy(SYNC_NONE), fd(-1), fileLength(0), pending(0), unsynced(false),
+flusher(0)
 {
 	this->layout = layout;
 	activateOptions();
@@ -37,14 +86,20 @@ FileAppender::FileAppender(LayoutPtr layout, const tstring& fileName,
 
 FileAppender::FileAppender(LayoutPtr layout, const tstring& fileName,
 	bool append)
-: fileName(fileName), fileAppend(append), bufferedIO(false), bufferSize(8*1024)
+: fileName(fileName), fileAppend(append), bufferedIO(false), bufferSize(8*1024),
+buffer(0), flushInterval(DEFAULT_FLUSH_INTERVAL), dirty(false), rawIO(false),
+syncPolicy(SYNC_NONE), fd(-1), fileLength(0), pending(0), unsynced(false),
+flusher(0)
 {
 	this->layout = layout;
 	activateOptions();
 }
 
 FileAppender::FileAppender(LayoutPtr layout, const tstring& fileName)
-: fileName(fileName), fileAppend(true), bufferedIO(false), bufferSize(8*1024)
+: fileName(fileName), fileAppend(true), bufferedIO(false), bufferSize(8*1024),
+buffer(0), flushInterval(DEFAULT_FLUSH_INTERVAL), dirty(false), rawIO(false),
+syncPolicy(SYNC_NONE), fd(-1), fileLength(0), pending(0), unsynced(false),
+flusher(0)
 {
 	this->layout = layout;
 	activateOptions();
@@ -53,6 +108,10 @@ FileAppender::FileAppender(LayoutPtr layout, const tstring& fileName)
 FileAppender::~FileAppender()
 {
 	finalize();
+
+	// the file using the buffer is closed, the stream lets go of it
+	ofs.rdbuf()->pubsetbuf(0, 0);
+	delete [] buffer;
 }
 
 void FileAppender::setFile(const tstring& file)
@@ -62,12 +121,471 @@ void FileAppender::setFile(const tstring& file)
 	fileName = StringHelper::trim(file);
 }
 
+namespace
+{
+#ifdef LOG4CXX_RAW_IO
+	/** The largest number of events written by one system call. */
+	const int MAX_IOV = 64;
+
+	struct Chunk
+	{
+		const char * data;
+		size_t length;
+	};
+
+	/** Write the chunks in order, returns the number of bytes written
+	or -1 on error. */
+	long writeChunks(int fd, Chunk * chunks, int count)
+	{
+		long written = 0;
+
+		while(count > 0)
+		{
+#ifdef HAVE_WRITEV
+			struct iovec iov[MAX_IOV];
+			int iovCount = count < MAX_IOV ? count : MAX_IOV;
+			for(int i = 0; i < iovCount; i++)
+			{
+				iov[i].iov_base = (void *)chunks[i].data;
+				iov[i].iov_len = chunks[i].length;
+			}
+
+			ssize_t n = ::writev(fd, iov, iovCount);
+#else
+			ssize_t n = ::write(fd, chunks->data, chunks->length);
+#endif
+			if(n < 0)
+			{
+				if(errno == EINTR)
+				{
+					continue;
+				}
+
+				return -1;
+			}
+
+			written += n;
+
+			// skip what was written, a chunk may be written in part
+			size_t left = (size_t)n;
+			while(count > 0 && left >= chunks->length)
+			{
+				left -= chunks->length;
+				chunks++;
+				count--;
+			}
+
+			if(count > 0)
+			{
+				chunks->data += left;
+				chunks->length -= left;
+			}
+		}
+
+		return written;
+	}
+
+	void syncDescriptor(int fd)
+	{
+#ifdef HAVE_FDATASYNC
+		::fdatasync(fd);
+#else
+		::fsync(fd);
+#endif
+	}
+#endif
+}
+
 void FileAppender::closeWriter()
 {
-	ofs.close();
+	closeFile();
 	os = 0;
 }
 
+void FileAppender::close()
+{
+	// the flusher takes the appender lock, it is stopped without it
+	stopFlusher();
+	WriterAppender::close();
+}
+
+bool FileAppender::openFile(bool append)
+{
+	dirty = false;
+
+#ifdef LOG4CXX_RAW_IO
+	if(rawIO)
+	{
+		fd = ::open(T2A(fileName.c_str()),
+			O_WRONLY|O_CREAT|O_APPEND|(append ? 0 : O_TRUNC), 0666);
+		if(fd < 0)
+		{
+			return false;
+		}
+
+		struct stat status;
+		fileLength = (::fstat(fd, &status) == 0) ? (long)status.st_size : 0;
+		pending = 0;
+		unsynced = false;
+
+		// the stream is not used, os only tells the appender is ready
+		this->os = &ofs;
+		return true;
+	}
+#endif
+
+	ofs.open(T2A(fileName.c_str()), (append ? std::ios::app :
+		std::ios::trunc)|std::ios::out);
+
+	if(!ofs.is_open())
+	{
+		return false;
+	}
+
+	this->os = &ofs;
+	return true;
+}
+
+void FileAppender::closeFile()
+{
+#ifdef LOG4CXX_RAW_IO
+	if(fd >= 0)
+	{
+		flushRaw();
+		if(syncPolicy != SYNC_NONE && unsynced)
+		{
+			syncDescriptor(fd);
+		}
+
+		::close(fd);
+		fd = -1;
+	}
+#endif
+
+	ofs.close();
+	ofs.clear();
+	dirty = false;
+}
+
+long FileAppender::getFileLength()
+{
+	if(fd >= 0)
+	{
+		return fileLength + (long)pending;
+	}
+
+	return (long)ofs.tellp();
+}
+
+void FileAppender::writeRaw(const TCHAR * text, size_t length)
+{
+#ifdef LOG4CXX_RAW_IO
+	if(buffer != 0 && bufferedIO)
+	{
+		if(pending + length <= (size_t)bufferSize)
+		{
+			memcpy(buffer + pending, text, length);
+			pending += length;
+			return;
+		}
+	}
+
+	// the buffer goes first, the text is not copied into it
+	Chunk chunks[2];
+	int count = 0;
+	if(pending > 0)
+	{
+		chunks[count].data = buffer;
+		chunks[count].length = pending;
+		count++;
+	}
+
+	chunks[count].data = text;
+	chunks[count].length = length;
+	count++;
+
+	long written = writeChunks(fd, chunks, count);
+	pending = 0;
+	if(written < 0)
+	{
+		errorHandler->error(_T("Unable to write to file: ") + fileName);
+		return;
+	}
+
+	fileLength += written;
+	unsynced = true;
+	syncRaw();
+#endif
+}
+
+void FileAppender::flushRaw()
+{
+#ifdef LOG4CXX_RAW_IO
+	if(pending == 0)
+	{
+		return;
+	}
+
+	Chunk chunk;
+	chunk.data = buffer;
+	chunk.length = pending;
+
+	long written = writeChunks(fd, &chunk, 1);
+	pending = 0;
+	if(written < 0)
+	{
+		errorHandler->error(_T("Unable to write to file: ") + fileName);
+		return;
+	}
+
+	fileLength += written;
+	unsynced = true;
+	syncRaw();
+#endif
+}
+
+void FileAppender::syncRaw()
+{
+#ifdef LOG4CXX_RAW_IO
+	if(syncPolicy == SYNC_BATCH && unsynced)
+	{
+		syncDescriptor(fd);
+		unsynced = false;
+	}
+#endif
+}
+
+void FileAppender::flushFile()
+{
+	if(fd >= 0)
+	{
+		flushRaw();
+	}
+	else
+	{
+		os->flush();
+	}
+
+	dirty = false;
+}
+
+void FileAppender::subAppend(const LoggingEvent& event)
+{
+	if(fd >= 0)
+	{
+		// the text keeps its capacity from one event to the next
+		text.erase();
+		layout->format(text, event);
+		FileAppender::subAppend(event, text);
+		return;
+	}
+
+	WriterAppender::subAppend(event);
+
+	if(bufferedIO && !immediateFlush)
+	{
+		if(event.getLevel().isGreaterOrEqual(Level::WARN))
+		{
+			flushFile();
+		}
+		else
+		{
+			dirty = true;
+		}
+	}
+}
+
+void FileAppender::subAppend(const LoggingEvent& event,
+	const tstring& formatted)
+{
+	if(fd >= 0)
+	{
+		writeRaw(formatted.data(), formatted.size());
+	}
+	else
+	{
+		WriterAppender::subAppend(event, formatted);
+	}
+
+	if(bufferedIO && !immediateFlush)
+	{
+		if(event.getLevel().isGreaterOrEqual(Level::WARN))
+		{
+			flushFile();
+		}
+		else
+		{
+			dirty = pending > 0 || fd < 0;
+		}
+	}
+}
+
+void FileAppender::appendBatch(const spi::LoggingEventList& events)
+{
+#ifdef LOG4CXX_RAW_IO
+	if(fd < 0)
+	{
+		WriterAppender::appendBatch(events);
+		return;
+	}
+
+	if(!checkEntryConditions())
+	{
+		return;
+	}
+
+	// each event is formatted in its own text, kept between batches
+	size_t count = events.size();
+	if(batchText.size() < count)
+	{
+		batchText.resize(count);
+	}
+
+	std::vector<Chunk> chunks;
+	chunks.reserve(count + 1);
+
+	if(pending > 0)
+	{
+		Chunk chunk;
+		chunk.data = buffer;
+		chunk.length = pending;
+		chunks.push_back(chunk);
+	}
+
+	for(size_t i = 0; i < count; i++)
+	{
+		tstring& text = batchText[i];
+		text.erase();
+		layout->format(text, *events[i]);
+
+		Chunk chunk;
+		chunk.data = text.data();
+		chunk.length = text.size();
+		chunks.push_back(chunk);
+	}
+
+	long written = writeChunks(fd, &chunks[0], (int)chunks.size());
+	pending = 0;
+	dirty = false;
+	if(written < 0)
+	{
+		errorHandler->error(_T("Unable to write to file: ") + fileName);
+		return;
+	}
+
+	fileLength += written;
+	unsynced = true;
+	syncRaw();
+#else
+	WriterAppender::appendBatch(events);
+#endif
+}
+
+void FileAppender::writeHeader()
+{
+	if(fd < 0)
+	{
+		WriterAppender::writeHeader();
+		return;
+	}
+
+	if(layout != 0)
+	{
+		tostringstream header;
+		layout->appendHeader(header);
+		text = header.str();
+		if(!text.empty())
+		{
+			writeRaw(text.data(), text.size());
+		}
+	}
+}
+
+void FileAppender::writeFooter()
+{
+	if(fd < 0)
+	{
+		WriterAppender::writeFooter();
+		return;
+	}
+
+	if(layout != 0)
+	{
+		tostringstream footer;
+		layout->appendFooter(footer);
+		text = footer.str();
+		if(!text.empty())
+		{
+			writeRaw(text.data(), text.size());
+		}
+
+		flushRaw();
+	}
+}
+
+void FileAppender::flushBuffer()
+{
+#ifdef LOG4CXX_RAW_IO
+	int syncFd = -1;
+#endif
+
+	{
+		synchronized sync(this);
+
+		if(dirty && os != 0)
+		{
+			flushFile();
+		}
+
+#ifdef LOG4CXX_RAW_IO
+		// synced on a duplicate without the lock, the file may be
+		// closed meanwhile
+		if(fd >= 0 && syncPolicy == SYNC_INTERVAL && unsynced)
+		{
+			syncFd = ::dup(fd);
+			unsynced = false;
+		}
+#endif
+	}
+
+#ifdef LOG4CXX_RAW_IO
+	if(syncFd >= 0)
+	{
+		syncDescriptor(syncFd);
+		::close(syncFd);
+	}
+#endif
+}
+
+void FileAppender::startFlusher()
+{
+	synchronized sync(this);
+
+	if(flusher == 0 && !closed)
+	{
+		flusher = new Flusher(this);
+		flusher->start();
+	}
+}
+
+void FileAppender::stopFlusher()
+{
+	Flusher * stopped;
+	{
+		synchronized sync(this);
+		stopped = flusher;
+		flusher = 0;
+	}
+
+	if(stopped != 0)
+	{
+		// the flusher thread deletes its Thread object when run
+		// returns, so it cannot be joined: wait for the end of run.
+		flusherStop.post();
+		flusherEnded.wait();
+	}
+}
+
 void FileAppender::setBufferedIO(bool bufferedIO)
 {
 	this->bufferedIO = bufferedIO;
@@ -96,14 +614,39 @@ void FileAppender::setOption(const std::string& option,
 	{
 		bufferSize = OptionConverter::toFileSize(value, 8*1024);
 	}
+	else if (StringHelper::equalsIgnoreCase(option, _T("flushinterval")))
+	{
+		flushInterval = OptionConverter::toInt(value, DEFAULT_FLUSH_INTERVAL);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, _T("rawio")))
+	{
+		rawIO = OptionConverter::toBoolean(value, false);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, _T("sync")))
+	{
+		if (StringHelper::equalsIgnoreCase(value, _T("batch")))
+		{
+			syncPolicy = SYNC_BATCH;
+		}
+		else if (StringHelper::equalsIgnoreCase(value, _T("interval")))
+		{
+			syncPolicy = SYNC_INTERVAL;
+		}
+		else
+		{
+			syncPolicy = SYNC_NONE;
+		}
+	}
 	else
 	{
-		WriterAppender::setOption(name, value);
+		WriterAppender::setOption(option, value);
 	}
 }
 
 void FileAppender::activateOptions()
 {
+	WriterAppender::activateOptions();
+
 	if (!fileName.empty())
 	{
 		LOGLOG_DEBUG(_T("FileAppender::activateOptions called : ")
@@ -114,28 +657,47 @@ void FileAppender::activateOptions()
 			setImmediateFlush(false);
 		}
 
-		if(ofs.is_open())
+		if(os != 0)
 		{
 			reset();
 		}
 
-	/*	if (bufferedIO && bufferSize > 0)
+#ifndef LOG4CXX_RAW_IO
+		if (rawIO)
 		{
-			buffer = new char[bufferSize];
-			out.rdbuf()->setbuf(buffer, 0);
-		}*/
+			LogLog::warn(_T("RawIO is not available, appender [") + name
+				+ _T("] writes through a stream."));
+			rawIO = false;
+		}
+#endif
 
-		ofs.open(T2A(fileName.c_str()), (fileAppend ? std::ios::app :
-			std::ios::trunc)|std::ios::out);
+		// the buffer must be given to the stream before it is opened
+		if (bufferedIO && bufferSize > 0)
+		{
+			// the stream must not keep the previous buffer once freed
+			ofs.rdbuf()->pubsetbuf(0, 0);
+			delete [] buffer;
+			buffer = new TCHAR[bufferSize];
+			if (!rawIO)
+			{
+				ofs.rdbuf()->pubsetbuf(buffer, bufferSize);
+			}
+		}
 
-		if(!ofs.is_open())
+		if(!openFile(fileAppend))
 		{
 			errorHandler->error(_T("Unable to open file: ") + fileName);
 			return;
 		}
 
-		this->os = &ofs;
 		writeHeader();
+
+		if ((bufferedIO || (fd >= 0 && syncPolicy == SYNC_INTERVAL))
+			&& flushInterval > 0)
+		{
+			startFlusher();
+		}
+
 		LogLog::debug(_T("FileAppender::activateOptions ended"));	}
 	else
 	{
@@ -144,4 +706,3 @@ void FileAppender::activateOptions()
 	}
 }
 
-
@@ -0,0 +1,158 @@
+/***************************************************************************
+                          hazardpointer.cpp  -  class HazardPointer
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/helpers/hazardpointer.h>
+#include <log4cxx/helpers/threadspecificdata.h>
+#include <log4cxx/helpers/atomic.h>
+
+using namespace log4cxx::helpers;
+
+struct HazardPointer::Record
+{
+	enum { SLOT_COUNT = 8 };
+
+	void * volatile slots[SLOT_COUNT];
+
+	/** Number of slots in use by the thread. */
+	int depth;
+
+	/** Is the record owned by a thread? */
+	volatile long active;
+
+	/** The next record of the list, never removed. */
+	Record * next;
+};
+
+namespace
+{
+	HazardPointer::Record * volatile records = 0;
+
+	/** Number of threads protecting objects beyond their slots. */
+	volatile long overflows = 0;
+
+	void releaseRecord(void * data)
+	{
+		// the record is kept for the next thread
+		Atomic::set(&((HazardPointer::Record *)data)->active, 0);
+	}
+
+	ThreadSpecificData currentRecord(releaseRecord);
+
+	HazardPointer::Record * getRecord()
+	{
+		HazardPointer::Record * record =
+			(HazardPointer::Record *)currentRecord.GetData();
+		if (record != 0)
+		{
+			return record;
+		}
+
+		// reuse the record of a thread which exited
+		for (record = (HazardPointer::Record *)Atomic::getPointer(
+			(void * const volatile *)&records);
+			record != 0; record = record->next)
+		{
+			if (Atomic::get(&record->active) == 0 &&
+				Atomic::compareAndSet(&record->active, 0, 1))
+			{
+				break;
+			}
+		}
+
+		if (record == 0)
+		{
+			record = new HazardPointer::Record;
+			for (int i = 0; i < HazardPointer::Record::SLOT_COUNT; i++)
+			{
+				record->slots[i] = 0;
+			}
+
+			record->active = 1;
+
+			do
+			{
+				record->next = (HazardPointer::Record *)Atomic::getPointer(
+					(void * const volatile *)&records);
+			}
+			while (!Atomic::compareAndSetPointer(
+				(void * volatile *)&records, record->next, record));
+		}
+
+		record->depth = 0;
+		currentRecord.SetData(record);
+		return record;
+	}
+}
+
+HazardPointer::HazardPointer(void * const volatile * source)
+: record(getRecord()), slot(record->depth++)
+{
+	if (slot >= Record::SLOT_COUNT)
+	{
+		// the writers keep all their retired objects meanwhile
+		Atomic::increment(&overflows);
+		pointer = Atomic::getPointer(source);
+		return;
+	}
+
+	// the pointer is published, then checked to be still shared: a
+	// writer replacing it afterwards sees the slot when it scans them
+	void * current = Atomic::getPointer(source);
+	do
+	{
+		pointer = current;
+		Atomic::exchangePointer(&record->slots[slot], pointer);
+		current = Atomic::getPointer(source);
+	}
+	while (current != pointer);
+}
+
+HazardPointer::~HazardPointer()
+{
+	if (slot >= Record::SLOT_COUNT)
+	{
+		Atomic::decrement(&overflows);
+	}
+	else
+	{
+		Atomic::setPointer(&record->slots[slot], 0);
+	}
+
+	record->depth--;
+}
+
+bool HazardPointer::isProtected(void * pointer)
+{
+	if (Atomic::get(&overflows) != 0)
+	{
+		return true;
+	}
+
+	for (Record * record = (Record *)Atomic::getPointer(
+		(void * const volatile *)&records);
+		record != 0; record = record->next)
+	{
+		for (int i = 0; i < Record::SLOT_COUNT; i++)
+		{
+			if (Atomic::getPointer(&record->slots[i]) == pointer)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
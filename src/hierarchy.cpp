@@ -23,6 +23,8 @@
 #include <algorithm>
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/appender.h>
+#include <log4cxx/helpers/atomic.h>
+#include <log4cxx/helpers/hazardpointer.h>
 
 using namespace log4cxx;
 using namespace log4cxx::spi;
@@ -38,10 +40,73 @@ namespace {
 
         return val;
     }
+
+	// FNV-1a hash of a logger name
+	unsigned long hashName(const tstring& name)
+	{
+		unsigned long hash = 2166136261UL;
+		tstring::const_iterator it, itEnd = name.end();
+
+		for(it = name.begin(); it != itEnd; it++)
+		{
+			hash = (hash ^ (unsigned long)*it) * 16777619UL;
+		}
+
+		return hash;
+	}
+
+	const int INITIAL_TABLE_CAPACITY = 256;
 }
 
-Hierarchy::Hierarchy(LoggerPtr root) : root(root),
-emittedNoAppenderWarning(false), emittedNoResourceBundleWarning(false)
+/**
+Open addressing hash table with linear probing. The table is kept at
+most half full so that every probe sequence ends on an empty slot.
+The hash of an entry is written before its logger is published.
+*/
+struct Hierarchy::LoggerTable
+{
+	LoggerTable(int capacity) : capacity(capacity), size(0)
+	{
+		hashes = new unsigned long[capacity];
+		slots = new Logger * volatile[capacity];
+		for (int i = 0; i < capacity; i++)
+		{
+			slots[i] = 0;
+		}
+	}
+
+	~LoggerTable()
+	{
+		delete [] hashes;
+		delete [] slots;
+	}
+
+	void insert(unsigned long hash, Logger * logger)
+	{
+		int mask = capacity - 1;
+		int i = (int)(hash & mask);
+		while (slots[i] != 0)
+		{
+			i = (i + 1) & mask;
+		}
+
+		hashes[i] = hash;
+		Atomic::setPointer((void * volatile *)&slots[i], logger);
+		size++;
+	}
+
+	int capacity;
+	int size;
+	unsigned long * hashes;
+	Logger * volatile * slots;
+
+	/** The loggers removed from the hierarchy while in this table. */
+	LoggerList cleared;
+};
+
+Hierarchy::Hierarchy(LoggerPtr root) : root(root), generation(0),
+emittedNoAppenderWarning(false), emittedNoResourceBundleWarning(false),
+table(new LoggerTable(INITIAL_TABLE_CAPACITY))
 {
 	// Enable all level levels by default.
 	setThreshold(Level::ALL);
@@ -51,6 +116,7 @@ emittedNoAppenderWarning(false), emittedNoResourceBundleWarning(false)
 
 Hierarchy::~Hierarchy()
 {
+	delete table;
 }
 
 void Hierarchy::addHierarchyEventListener(spi::HierarchyEventListenerPtr listener)
@@ -69,7 +135,14 @@ void Hierarchy::clear()
 {
 	mapCs.lock();
 
+	// lock free readers may still return the cleared loggers, which
+	// live as long as the table they are found in
+	table->cleared = copyLoggers();
 	loggers.clear();
+
+	replaceTable(new LoggerTable(INITIAL_TABLE_CAPACITY));
+
+	levelsChanged();
 	
 	mapCs.unlock();
 }
@@ -89,18 +162,14 @@ void Hierarchy::emitNoAppenderWarning(LoggerPtr logger)
 
 LoggerPtr Hierarchy::exists(const tstring& name)
 {
-	mapCs.lock();
-	
-	LoggerMap::iterator it = loggers.find(name);
-	return (it != loggers.end()) ? it->second : 0;
-
-	mapCs.unlock();
+	return findLogger(name);
 }
 	
 void Hierarchy::setThreshold(const Level& l)
 {
 	thresholdInt = l.level;
 	threshold = &l;
+	levelsChanged();
 }
 
 void Hierarchy::setThreshold(const tstring& levelStr)
@@ -148,6 +217,16 @@ const Level& Hierarchy::getThreshold()
 	return *threshold;
 }
 
+volatile long * Hierarchy::getGenerationCounter()
+{
+	return &generation;
+}
+
+void Hierarchy::levelsChanged()
+{
+	Atomic::increment(&generation);
+}
+
 LoggerPtr Hierarchy::getLogger(const tstring& name)
 {
 	return getLogger(name, defaultFactory);
@@ -155,10 +234,13 @@ LoggerPtr Hierarchy::getLogger(const tstring& name)
 
 LoggerPtr Hierarchy::getLogger(const tstring& name, spi::LoggerFactoryPtr factory)
 {
-	// Synchronize to prevent write conflicts. Read conflicts (in
-	// getEffectiveLevel method) are possible only if variable
-	// assignments are non-atomic.
-	LoggerPtr logger;
+	// Existing loggers are found without any lock. Creation is
+	// synchronized to prevent write conflicts in the hierarchy.
+	LoggerPtr logger = findLogger(name);
+	if (logger != 0)
+	{
+		return logger;
+	}
 
 	mapCs.lock();
 
@@ -183,6 +265,12 @@ LoggerPtr Hierarchy::getLogger(const tstring& name, spi::LoggerFactoryPtr factor
 		}
 
 		updateParents(logger);
+
+		// publish the logger once it is linked in the hierarchy
+		publishLogger(logger);
+
+		// the parents of existing loggers may have changed
+		levelsChanged();
 	}
 
 	mapCs.unlock();
@@ -193,7 +281,14 @@ LoggerPtr Hierarchy::getLogger(const tstring& name, spi::LoggerFactoryPtr factor
 LoggerList Hierarchy::getCurrentLoggers()
 {
 	mapCs.lock();
+	LoggerList v = copyLoggers();
+	mapCs.unlock();
 
+	return v;
+}
+
+LoggerList Hierarchy::copyLoggers()
+{
 	LoggerList v;
 	LoggerMap::iterator it, itEnd = loggers.end();
 
@@ -202,8 +297,6 @@ LoggerList Hierarchy::getCurrentLoggers()
 		v.push_back(it->second);
 	}
 
-	mapCs.unlock();
-
 	return v;
 }
 
@@ -220,17 +313,16 @@ bool Hierarchy::isDisabled(int level)
 
 void Hierarchy::resetConfiguration()
 {
+	// no logger is created while the levels are reset
 	mapCs.lock();
-	
+
 	getRootLogger()->setLevel(Level::DEBUG);
 	//root->setResourceBundle(0);
 	setThreshold(Level::ALL);
 	
-	shutdown(); // nested locks are OK
-	
-	LoggerList loggers = getCurrentLoggers();
-	LoggerList::iterator it, itEnd = loggers.end();
+	LoggerList loggers = copyLoggers();
 
+	LoggerList::iterator it, itEnd = loggers.end();
 	for (it = loggers.begin(); it != itEnd; it++)
 	{
 		LoggerPtr& logger = *it;
@@ -242,21 +334,28 @@ void Hierarchy::resetConfiguration()
 	//rendererMap.clear();
 
 	mapCs.unlock();
+
+	// the appenders closed may create loggers
+	closeAppenders(loggers);
 }
 
 void Hierarchy::shutdown()
+{
+	closeAppenders(getCurrentLoggers());
+}
+
+void Hierarchy::closeAppenders(const LoggerList& loggers)
 {
 	LoggerPtr root = getRootLogger();
 	
 	// begin by closing nested appenders
 	root->closeNestedAppenders();
 	
-	LoggerList loggers = getCurrentLoggers();
-	LoggerList::iterator it, itEnd = loggers.end();
+	LoggerList::const_iterator it, itEnd = loggers.end();
 
 	for (it = loggers.begin(); it != itEnd; it++)
 	{
-		LoggerPtr& logger = *it;
+		const LoggerPtr& logger = *it;
 		logger->closeNestedAppenders();
 	}
 
@@ -264,7 +363,7 @@ void Hierarchy::shutdown()
 	root->removeAllAppenders();
 	for (it = loggers.begin(); it != itEnd; it++)
 	{
-		LoggerPtr& logger = *it;
+		const LoggerPtr& logger = *it;
 		logger->removeAllAppenders();
 	}
 }
@@ -293,7 +392,7 @@ void Hierarchy::updateParents(LoggerPtr logger)
 		}
 		else
 		{
-			ProvisionNodeMap::iterator it2 = provisionNodes.find(name);
+			ProvisionNodeMap::iterator it2 = provisionNodes.find(substr);
 			if (it2 != provisionNodes.end())
 			{
 				it2->second.push_back(logger);
@@ -302,7 +401,7 @@ void Hierarchy::updateParents(LoggerPtr logger)
 			{
 				ProvisionNode node(logger);
 				provisionNodes.insert(
-					ProvisionNodeMap::value_type(name, node));
+					ProvisionNodeMap::value_type(substr, node));
 			}
 		}
 	}
@@ -334,3 +433,57 @@ void Hierarchy::updateChildren(ProvisionNode& pn, LoggerPtr logger)
 		}
 	}
 }
+
+LoggerPtr Hierarchy::findLogger(const tstring& name)
+{
+	// the table is not deleted while the hazard pointer protects it,
+	// nor the loggers it holds
+	HazardPointer hazard((void * const volatile *)&table);
+	LoggerTable * t = (LoggerTable *)hazard.get();
+	unsigned long hash = hashName(name);
+	int mask = t->capacity - 1;
+
+	for (int i = (int)(hash & mask); ; i = (i + 1) & mask)
+	{
+		Logger * logger = (Logger *)Atomic::getPointer(
+			(void * const volatile *)&t->slots[i]);
+
+		if (logger == 0)
+		{
+			return 0;
+		}
+		else if (t->hashes[i] == hash && logger->name == name)
+		{
+			return logger;
+		}
+	}
+}
+
+void Hierarchy::publishLogger(const LoggerPtr& logger)
+{
+	LoggerTable * t = table;
+
+	if ((t->size + 1) * 2 > t->capacity)
+	{
+		// readers of the previous table fall back to the map
+		LoggerTable * bigger = new LoggerTable(t->capacity * 2);
+		for (int i = 0; i < t->capacity; i++)
+		{
+			if (t->slots[i] != 0)
+			{
+				bigger->insert(t->hashes[i], t->slots[i]);
+			}
+		}
+
+		replaceTable(bigger);
+		t = bigger;
+	}
+
+	t->insert(hashName(logger->name), logger);
+}
+
+void Hierarchy::replaceTable(LoggerTable * newTable)
+{
+	retiredTables.retire((LoggerTable *)Atomic::exchangePointer(
+		(void * volatile *)&table, newTable));
+}
@@ -53,11 +53,12 @@ void HTMLLayout::format(tostream& output, const spi::LoggingEvent& event)
 	output << std::endl << _T("<tr>") << std::endl;
 
 	output << _T("<td>");
-	ISO8601DateFormat().format(output, event.getTimeStamp());
+	dateFormat.format(output, event.getTimeStamp(),
+		event.getMicroseconds());
 	output << _T("</td>") << std::endl;
 
-	output << _T("<td title=\"") << event.getThreadId() << _T(" thread\">");
-	output << event.getThreadId();
+	output << _T("<td title=\"") << event.getThreadName() << _T(" thread\">");
+	output << event.getThreadName();
 	output << _T("</td>") << std::endl;
 
 	output << _T("<td title=\"Level\">");
@@ -87,9 +88,11 @@ void HTMLLayout::format(tostream& output, const spi::LoggingEvent& event)
 
 	if(locationInfo)
 	{
-		USES_CONVERSION;
 		output << _T("<td>");
-		Transform::appendEscapingTags(output, A2T(event.getFile()));
+		if (event.getFileName() != 0)
+		{
+			Transform::appendEscapingTags(output, event.getFileName());
+		}
 		output << _T(':');
 		output << event.getLine();
 		output << _T("</td>") << std::endl;
@@ -129,7 +132,7 @@ void HTMLLayout::appendHeader(tostream& output)
 	output << _T("<body bgcolor=\"#FFFFFF\" topmargin=\"6\" leftmargin=\"6\">") << std::endl;
 	output << _T("<hr size=\"1\" noshade>") << std::endl;
 	output << _T("Log session start time ");
-	ISO8601DateFormat().format(output, time(0));
+	dateFormat.format(output, time(0));
 	output << _T("<br>") << std::endl;
 	output << _T("<br>") << std::endl;
 	output << _T("<table cellspacing=\"0\" cellpadding=\"4\" border=\"1\" bordercolor=\"#224466\" width=\"100%\">") << std::endl;
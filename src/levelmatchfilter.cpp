@@ -56,9 +56,14 @@ const tstring& LevelMatchFilter::getLevelToMatch() const
 }
   
 int LevelMatchFilter::decide(const log4cxx::spi::LoggingEvent& event)
+{
+	return decideLevel(event.getLevel());
+}
+
+int LevelMatchFilter::decideLevel(const Level& level)
 {
 	bool matchOccured = false;
-	if(this->levelToMatch->equals(event.getLevel()))
+	if(this->levelToMatch->equals(level))
 	{
 		matchOccured = true;
 	}
@@ -52,13 +52,18 @@ else if (StringHelper::equalsIgnoreCase(option, LEVEL_MAX_OPTION))
 
 int LevelRangeFilter::decide(const log4cxx::spi::LoggingEvent& event)
 {
-	if (!event.getLevel().isGreaterOrEqual(*levelMin))
+	return decideLevel(event.getLevel());
+}
+
+int LevelRangeFilter::decideLevel(const Level& level)
+{
+	if (!level.isGreaterOrEqual(*levelMin))
 	{
 		// level of event is less than minimum
 		return Filter::DENY;
 	}
 
-	if (event.getLevel().toInt() > levelMax->toInt())
+	if (level.toInt() > levelMax->toInt())
 	{
 		// level of event is greater than maximum
 		// Alas, there is no Level.isGreater method. and using
@@ -21,29 +21,168 @@
 #include <log4cxx/logmanager.h>
 #include <log4cxx/spi/loggerfactory.h>
 #include <log4cxx/appender.h>
+#include <log4cxx/appenderskeleton.h>
 #include <log4cxx/level.h>
 #include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/hazardpointer.h>
+#include <algorithm>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 using namespace log4cxx::spi;
 
+namespace
+{
+	// generation counter of the loggers not yet attached to a repository
+	volatile long noRepositoryGeneration = 0;
+
+	// the predefined levels, for which the routes list the appenders
+	// whose threshold accepts the events
+	const int routeLevels[] =
+	{
+		Level::ALL_INT, Level::DEBUG_INT, Level::INFO_INT, Level::WARN_INT,
+		Level::ERROR_INT, Level::FATAL_INT, Level::OFF_INT
+	};
+
+	const int ROUTE_LEVEL_COUNT = sizeof(routeLevels) / sizeof(routeLevels[0]);
+
+	/** Index of level in routeLevels, or -1. */
+	inline int getRouteLevel(int level)
+	{
+		switch(level)
+		{
+		case Level::ALL_INT: return 0;
+		case Level::DEBUG_INT: return 1;
+		case Level::INFO_INT: return 2;
+		case Level::WARN_INT: return 3;
+		case Level::ERROR_INT: return 4;
+		case Level::FATAL_INT: return 5;
+		case Level::OFF_INT: return 6;
+		default: return -1;
+		}
+	}
+}
+
+struct Logger::Route
+{
+	struct Entry
+	{
+		Appender * appender;
+
+		// the threshold of appender skeletons is checked inline
+		AppenderSkeleton * skeleton;
+	};
+
+	// keeps the appenders of the entries alive
+	AppenderList appenders;
+	std::vector<Entry> entries;
+
+	// for each predefined level, the appenders whose threshold
+	// accepts its events
+	std::vector<Appender *> accepting[ROUTE_LEVEL_COUNT];
+};
+
 Logger::Logger(const tstring& name)
-: name(name), level(&Level::OFF), additive(true)
+: name(name), level(&Level::OFF), repository(0), additive(true),
+enabledLevel(Level::OFF_INT), cachedGeneration(-1),
+generation(&noRepositoryGeneration), route(0),
+routeGeneration(-1), routeThresholdGeneration(-1)
 {
 
 }
 
 Logger::~Logger()
 {
+	delete route;
 }
 
 void Logger::addAppender(AppenderPtr newAppender)
 {
 	AppenderAttachableImpl::addAppender(newAppender);
+	Atomic::increment(generation);
 	repository->fireAddAppenderEvent(this, newAppender);
 }
 
+void Logger::removeAllAppenders()
+{
+	AppenderAttachableImpl::removeAllAppenders();
+	Atomic::increment(generation);
+}
+
+void Logger::removeAppender(AppenderPtr appender)
+{
+	AppenderAttachableImpl::removeAppender(appender);
+	Atomic::increment(generation);
+}
+
+void Logger::removeAppender(const tstring& name)
+{
+	AppenderAttachableImpl::removeAppender(name);
+	Atomic::increment(generation);
+}
+
+void Logger::updateRoute()
+{
+	// The generations are read first: if the configuration changes
+	// while the route is built, the route stays out of date and is
+	// built again on the next event.
+	long currentGeneration = Atomic::get(generation);
+	long thresholdGeneration = AppenderSkeleton::getThresholdGeneration();
+
+	// the appenders of the ancestors are read without holding the
+	// lock of this logger, each getAllAppenders takes its own lock.
+	Route * newRoute = new Route();
+	for(Logger * logger = this; logger != 0; logger = logger->parent)
+	{
+		AppenderList appenders = logger->getAllAppenders();
+		AppenderList::iterator it, itEnd = appenders.end();
+		for(it = appenders.begin(); it != itEnd; it++)
+		{
+			if(std::find(newRoute->appenders.begin(),
+				newRoute->appenders.end(), *it) == newRoute->appenders.end())
+			{
+				Route::Entry entry;
+				entry.appender = *it;
+				entry.skeleton = dynamic_cast<AppenderSkeleton *>(entry.appender);
+				newRoute->appenders.push_back(*it);
+				newRoute->entries.push_back(entry);
+
+				for(int i = 0; i < ROUTE_LEVEL_COUNT; i++)
+				{
+					if(entry.skeleton == 0 || routeLevels[i]
+						>= entry.skeleton->getThreshold().level)
+					{
+						newRoute->accepting[i].push_back(entry.appender);
+					}
+				}
+			}
+		}
+
+		if(!logger->additive)
+		{
+			break;
+		}
+	}
+
+	synchronized sync(this);
+
+	// another thread may have published a more recent route meanwhile
+	if(route != 0 && (long)((unsigned long)currentGeneration
+		- (unsigned long)routeGeneration) <= 0 &&
+		(long)((unsigned long)thresholdGeneration
+		- (unsigned long)routeThresholdGeneration) <= 0)
+	{
+		delete newRoute;
+		return;
+	}
+
+	Route * oldRoute = (Route *)Atomic::exchangePointer(
+		(void * volatile *)&route, newRoute);
+	Atomic::set(&routeGeneration, currentGeneration);
+	Atomic::set(&routeThresholdGeneration, thresholdGeneration);
+
+	retiredRoutes.retire(oldRoute);
+}
 
 void Logger::assertLog(bool assertion, const tstring& msg)
 {
@@ -55,19 +194,48 @@ void Logger::assertLog(bool assertion, const tstring& msg)
 
 void Logger::callAppenders(const spi::LoggingEvent& event)
 {
-	int writes = 0;
-
-	for(LoggerPtr logger = this; logger != 0; logger = logger->parent)
+	if (LOG4CXX_UNLIKELY(Atomic::get(&routeGeneration)
+		!= Atomic::get(generation) || Atomic::get(&routeThresholdGeneration)
+		!= AppenderSkeleton::getThresholdGeneration()))
 	{
-		writes += logger->appendLoopOnAppenders(event);
+		updateRoute();
+	}
 
-		if(!logger->additive)
+	// the route is not deleted while the hazard pointer protects it
+	HazardPointer hazard((void * const volatile *)&this->route);
+	Route * route = (Route *)hazard.get();
+
+	int routeLevel = getRouteLevel(event.getLevel().level);
+	if(routeLevel >= 0)
+	{
+		// the thresholds were checked when the route was built
+		const std::vector<Appender *>& appenders =
+			route->accepting[routeLevel];
+		std::vector<Appender *>::const_iterator it,
+			itEnd = appenders.end();
+		for(it = appenders.begin(); it != itEnd; it++)
 		{
-			break;
+			(*it)->doAppend(event);
 		}
 	}
+	else
+	{
+		int level = event.getLevel().level;
+		std::vector<Route::Entry>::const_iterator it,
+			itEnd = route->entries.end();
+		for(it = route->entries.begin(); it != itEnd; it++)
+		{
+			if(it->skeleton != 0
+				&& level < it->skeleton->getThreshold().level)
+			{
+				continue;
+			}
 
-	if(writes == 0)
+			it->appender->doAppend(event);
+		}
+	}
+
+	if(route->entries.empty())
 	{
 		repository->emitNoAppenderWarning(this);
 	}
@@ -75,9 +243,7 @@ void Logger::callAppenders(const spi::LoggingEvent& event)
 
 void Logger::closeNestedAppenders()
 {
-	synchronized sync(this);
-
-	
+	// getAllAppenders takes the logger lock and returns a copy
     AppenderList appenders = getAllAppenders();
     for(AppenderList::iterator it=appenders.begin(); it!=appenders.end(); ++it)
     {
@@ -87,12 +253,7 @@ void Logger::closeNestedAppenders()
 
 void Logger::debug(const tstring& message, const char* file, int line)
 {
-	if(repository->isDisabled(Level::DEBUG_INT))
-	{
-		return;
-	}
-	
-	if(Level::DEBUG.isGreaterOrEqual(getEffectiveLevel()))
+	if(isEnabledFor(Level::DEBUG_INT))
 	{
 		 forcedLog(Level::DEBUG, message, file, line);
 	}
@@ -100,12 +261,7 @@ void Logger::debug(const tstring& message, const char* file, int line)
 
 void Logger::error(const tstring& message, const char* file, int line)
 {
-	if(repository->isDisabled(Level::ERROR_INT))
-	{
-		return;
-	}
-
-	if(Level::ERROR.isGreaterOrEqual(getEffectiveLevel()))
+	if(isEnabledFor(Level::ERROR_INT))
 	{
 		 forcedLog(Level::ERROR, message, file, line);
 	}
@@ -113,12 +269,7 @@ void Logger::error(const tstring& message, const char* file, int line)
 
 void Logger::fatal(const tstring& message, const char* file, int line)
 {
-	if(repository->isDisabled(Level::FATAL_INT))
-	{
-		return;
-	}
-
-	if(Level::FATAL.isGreaterOrEqual(getEffectiveLevel()))
+	if(isEnabledFor(Level::FATAL_INT))
 	{
 		 forcedLog(Level::FATAL, message, file, line);
 	}
@@ -130,6 +281,12 @@ void Logger::forcedLog(const Level& level, const tstring& message,
 	callAppenders(LoggingEvent(this, level, message, file, line));
 }
 
+void Logger::forcedLog(const Level& level, const tstring& message,
+			spi::CallSite& callSite)
+{
+	callAppenders(LoggingEvent(this, level, message, callSite));
+}
+
 bool Logger::getAdditivity()
 {
 	return additive;
@@ -165,86 +322,72 @@ const Level& Logger::getLevel()
 
 void Logger::info(const tstring& message, const char* file, int line)
 {
-	if(repository->isDisabled(Level::INFO_INT))
-	{
-		return;
-	}
-
-	if(Level::INFO.isGreaterOrEqual(getEffectiveLevel()))
+	if(isEnabledFor(Level::INFO_INT))
 	{
 		 forcedLog(Level::INFO, message, file, line);
 	}
 }
 
-bool Logger::isDebugEnabled()
-{
-	if(repository->isDisabled(Level::DEBUG_INT))
-	{
-		return false;
-	}
-	
-	return Level::DEBUG.isGreaterOrEqual(getEffectiveLevel());
-}
-
 bool Logger::isEnabledFor(const Level& level)
 {
-	if(repository->isDisabled(level.level))
-	{
-		return false;
-	}
-	
-	return level.isGreaterOrEqual(getEffectiveLevel());
-}
-
-bool Logger::isInfoEnabled()
-{
-	if(repository->isDisabled(Level::INFO_INT))
-	{
-		return false;
-	}
-
-	return Level::INFO.isGreaterOrEqual(getEffectiveLevel());
-
+	return isEnabledFor(level.level);
 }
 
 void Logger::log(const Level& level, const tstring& message,
 	const char* file, int line)
 {
-
-	if(repository->isDisabled(level.level))
-	{
-		return;
-	}
-	if(level.isGreaterOrEqual(getEffectiveLevel()))
+	if(isEnabledFor(level.level))
 	{
 		forcedLog(level, message, file, line);
 	}
-
 }
 
 void Logger::setAdditivity(bool additive)
 {
 	this->additive = additive;
+
+	// the routes of this logger and of its descendants change too
+	Atomic::increment(generation);
 }
 
 void Logger::setHierarchy(spi::LoggerRepository * repository)
 {
 	this->repository = repository;
+	Atomic::set(&cachedGeneration, -1);
+	Atomic::set(&routeGeneration, -1);
+	generation = repository->getGenerationCounter();
 }
 
 void Logger::setLevel(const Level& level)
 {
 	this->level = &level;
+
+	// the effective level of the descendants may change too
+	Atomic::increment(generation);
 }
 
-void Logger::warn(const tstring& message, const char* file, int line)
+void Logger::updateEnabledLevel()
 {
-	if(repository->isDisabled(Level::WARN_INT))
+	synchronized sync(this);
+
+	// The generation is read first: if the configuration changes while
+	// the level is computed, the cache stays out of date and is
+	// computed again on the next check.
+	long currentGeneration = Atomic::get(generation);
+
+	int enabledLevel = getEffectiveLevel().level;
+	if(repository != 0 && repository->getThreshold().level > enabledLevel)
 	{
-		return;
+		enabledLevel = repository->getThreshold().level;
 	}
 
-	if(Level::WARN.isGreaterOrEqual(getEffectiveLevel()))
+	this->enabledLevel = enabledLevel;
+	Atomic::set(&cachedGeneration, currentGeneration);
+}
+
+void Logger::warn(const tstring& message, const char* file, int line)
+{
+	if(isEnabledFor(Level::WARN_INT))
 	{
 		 forcedLog(Level::WARN, message, file, line);
 	}
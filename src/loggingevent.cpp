@@ -17,55 +17,214 @@
 #include <log4cxx/spi/loggingevent.h>
 #include <log4cxx/ndc.h>
 
-#include <log4cxx/helpers/thread.h>
+#include <log4cxx/helpers/clock.h>
 #include <log4cxx/level.h>
 #include <log4cxx/helpers/socketoutputstream.h>
 #include <log4cxx/helpers/socketinputstream.h>
+#include <log4cxx/helpers/socketimpl.h>
 #include <log4cxx/helpers/loglog.h>
 
 using namespace log4cxx;
 using namespace log4cxx::spi;
 using namespace log4cxx::helpers;
 
+namespace
+{
+	/** The version of the format written by LoggingEvent::write. The
+	"L4" in the high bytes tells it from the events of the unversioned
+	format, which began with the length of the logger name. */
+	const int FORMAT_VERSION = 0x4C340002;
+
+	/** The most MDC keys an event read from a stream may have. The
+	strings themselves are bounded by SocketInputStream. */
+	const int MAX_MDC_SIZE = 256;
+
+	time_t readStartTime(long& microseconds)
+	{
+		time_t seconds;
+		Clock::getTime(seconds, microseconds);
+		return seconds;
+	}
+}
+
 // time at startup
-time_t LoggingEvent::startTime = time(0);
+long LoggingEvent::startMicroseconds = 0;
+time_t LoggingEvent::startTime = readStartTime(LoggingEvent::startMicroseconds);
 
 LoggingEvent::LoggingEvent()
-: timeStamp(0), level(&Level::OFF), ndcLookupRequired(true), line(0)
+: level(&Level::OFF), timeStamp(0), microseconds(0), callSite(0),
+file(0), line(-1)
 {
 }
 
 LoggingEvent::LoggingEvent(const LoggerPtr& logger, const Level& level,
 	const tstring& message, const char* file, int line)
-: logger(logger), level(&level), message(message), file((char*)file), 
-line(line), timeStamp(time(0)), ndcLookupRequired(true)
+: logger(logger), level(&level), message(message), callSite(0),
+file(file), line(line), ndc(NDC::getCurrentContext()),
+mdc(MDC::getCurrentMap())
 {
-	threadId = Thread::getCurrentThreadId();
+#ifdef UNICODE
+	if (file != 0)
+	{
+		USES_CONVERSION;
+		fileText = A2T(file);
+	}
+#endif
+
+	Clock::getTime(timeStamp, microseconds);
+	threadIdentity = ThreadIdentity::getCurrent();
+}
+
+LoggingEvent::LoggingEvent(const LoggerPtr& logger, const Level& level,
+	const tstring& message, CallSite& callSite)
+: logger(logger), level(&level), message(message), callSite(&callSite),
+file(0), line(-1), ndc(NDC::getCurrentContext()),
+mdc(MDC::getCurrentMap())
+{
+	Clock::getTime(timeStamp, microseconds);
+	threadIdentity = ThreadIdentity::getCurrent();
 }
 
 LoggingEvent::LoggingEvent(const LoggingEvent& event)
 : logger(event.logger), level(event.level), message(event.message),
-file(event.file), line(event.line), timeStamp(event.timeStamp),
-ndcLookupRequired(event.ndcLookupRequired), ndc(event.ndc),
-threadId(event.threadId)
+timeStamp(event.timeStamp), microseconds(event.microseconds),
+callSite(event.callSite), file(event.file), line(event.line),
+fileText(event.fileText), ndc(event.ndc), mdc(event.mdc),
+threadIdentity(event.threadIdentity)
+{
+}
+
+LoggingEvent& LoggingEvent::operator=(const LoggingEvent& event)
+{
+	if (this == &event)
+	{
+		return *this;
+	}
+
+	logger = event.logger;
+	level = event.level;
+	message.assign(event.message.data(), event.message.size());
+	timeStamp = event.timeStamp;
+	microseconds = event.microseconds;
+	callSite = event.callSite;
+	file = event.file;
+	line = event.line;
+	fileText.assign(event.fileText.data(), event.fileText.size());
+	ndc = event.ndc;
+	mdc = event.mdc;
+	threadIdentity = event.threadIdentity;
+
+	return *this;
+}
+
+char * LoggingEvent::getFile() const
 {
+	if (callSite != 0)
+	{
+		return (char *)callSite->file;
+	}
+
+#ifndef UNICODE
+	if (file == 0 && !fileText.empty())
+	{
+		return (char *)fileText.c_str();
+	}
+#endif
+
+	return (char *)file;
+}
+
+const TCHAR * LoggingEvent::getFileName() const
+{
+	if (callSite != 0)
+	{
+		return callSite->getFileName();
+	}
+
+	if (!fileText.empty())
+	{
+		// strip the directories
+		const TCHAR * path = fileText.c_str();
+		const TCHAR * base = path;
+		for (const TCHAR * p = path; *p != 0; p++)
+		{
+			if (*p == _T('/') || *p == _T('\\'))
+			{
+				base = p + 1;
+			}
+		}
+
+		return base;
+	}
+
+#ifdef UNICODE
+	return 0;
+#else
+	return file == 0 ? 0 : CallSite::getBaseName(file);
+#endif
 }
 
 const tstring& LoggingEvent::getNDC() const
 {
-	if(ndcLookupRequired)
+	static tstring emptyNDC;
+
+	if(ndc == 0)
+	{
+		return emptyNDC;
+	}
+
+	return ndc->getFullMessage();
+}
+
+const tstring& LoggingEvent::getThreadName() const
+{
+	static tstring emptyName;
+
+	if(threadIdentity == 0)
 	{
-		((LoggingEvent *)this)->ndcLookupRequired = false;
-		((LoggingEvent *)this)->ndc = NDC::get();
+		return emptyName;
 	}
 
-	return ndc;
+	return threadIdentity->getText();
+}
+
+const tstring& LoggingEvent::getMDC(int key) const
+{
+	static tstring emptyValue;
+
+	if(mdc != 0)
+	{
+		const tstring * value = mdc->get(key);
+		if(value != 0)
+		{
+			return *value;
+		}
+	}
+
+	return emptyValue;
+}
+
+const tstring& LoggingEvent::getMDC(const tstring& key) const
+{
+	static tstring emptyValue;
+
+	if(mdc != 0)
+	{
+		const tstring * value = mdc->get(key);
+		if(value != 0)
+		{
+			return *value;
+		}
+	}
+
+	return emptyValue;
 }
 
 void LoggingEvent::write(helpers::SocketOutputStreamPtr os) const
 {
-	tstring::size_type size;
-	
+	// format
+	os->write(FORMAT_VERSION);
+
 	// name
 	os->write(logger->getName());
 
@@ -77,19 +236,57 @@ void LoggingEvent::write(helpers::SocketOutputStreamPtr os) const
 
 	// timeStamp
 	os->write(timeStamp);
+	os->write(microseconds);
 
-	// line
-	os->write(line);
+	// file and line, the full path as given by the statement
+	if (callSite != 0 || file != 0)
+	{
+		USES_CONVERSION;
+		const char * path = (callSite != 0) ? callSite->file : file;
+		os->write(path == 0 ? tstring() : tstring(A2T(path)));
+	}
+	else
+	{
+		os->write(fileText);
+	}
+	os->write(getLine());
 
 	// ndc
 	os->write(getNDC());
 
-	// threadId
-	os->write(threadId);
+	// mdc
+	int mdcSize = (mdc == 0) ? 0 : mdc->size();
+	os->write(mdcSize);
+	for (int i = 0; i < mdcSize; i++)
+	{
+		os->write(mdc->getKeyName(i));
+		os->write(mdc->getValue(i));
+	}
+
+	// thread
+	if (threadIdentity == 0)
+	{
+		os->write((unsigned long)0);
+		os->write(tstring());
+	}
+	else
+	{
+		os->write(threadIdentity->getId());
+		os->write(threadIdentity->getName());
+	}
 }
 
 void LoggingEvent::read(helpers::SocketInputStreamPtr is)
 {
+	// format
+	int version;
+	is->read(version);
+	if (version != FORMAT_VERSION)
+	{
+		LogLog::error(_T("Unknown format of the event read."));
+		throw SocketException();
+	}
+
 	// name
 	tstring name;
 	is->read(name);
@@ -105,18 +302,44 @@ void LoggingEvent::read(helpers::SocketInputStreamPtr is)
 
 	// timeStamp
 	is->read(timeStamp);
+	is->read(microseconds);
 
-	// file
+	// file and line, kept by the event
+	callSite = 0;
 	file = 0;
-
-	// line
+	is->read(fileText);
 	is->read(line);
 
 	// ndc
-	is->read(ndc);
+	tstring ndcMessage;
+	is->read(ndcMessage);
+	ndc = ndcMessage.empty() ? 0 : new NDC::DiagnosticContext(ndcMessage, 0);
+
+	// mdc
+	int mdcSize;
+	is->read(mdcSize);
+	if (mdcSize < 0 || mdcSize > MAX_MDC_SIZE)
+	{
+		LogLog::error(_T("Too many MDC keys in the event read."));
+		throw SocketException();
+	}
+
+	MDC::Map * map = (mdcSize > 0) ? new MDC::Map() : 0;
+	mdc = map;
+	for (int i = 0; i < mdcSize; i++)
+	{
+		tstring key, value;
+		is->read(key);
+		is->read(value);
+		map->putRemote(key, value);
+	}
 
-	// threadId
+	// thread
+	unsigned long threadId;
+	tstring threadName;
 	is->read(threadId);
+	is->read(threadName);
+	threadIdentity = new ThreadIdentity(threadId, threadName);
 }
 
 LoggingEvent * LoggingEvent::copy() const
@@ -0,0 +1,72 @@
+/***************************************************************************
+                          loggingeventpool.cpp  -  class LoggingEventPool
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/helpers/loggingeventpool.h>
+#include <log4cxx/spi/loggingevent.h>
+
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+LoggingEventPool::LoggingEventPool()
+{
+}
+
+LoggingEventPool::~LoggingEventPool()
+{
+	std::vector<LoggingEvent *>::iterator it, itEnd = freeEvents.end();
+	for (it = freeEvents.begin(); it != itEnd; it++)
+	{
+		delete *it;
+	}
+}
+
+void LoggingEventPool::reserve(int size)
+{
+	freeEvents.reserve(size);
+	while ((int)freeEvents.size() < size)
+	{
+		freeEvents.push_back(new LoggingEvent());
+	}
+}
+
+LoggingEvent * LoggingEventPool::acquire(const LoggingEvent& event)
+{
+	if (freeEvents.empty())
+	{
+		return event.copy();
+	}
+
+	LoggingEvent * e = freeEvents.back();
+	freeEvents.pop_back();
+
+	// the assignment reuses the capacity of the strings of e
+	*e = event;
+	return e;
+}
+
+void LoggingEventPool::release(const LoggingEvent * event)
+{
+	freeEvents.push_back(const_cast<LoggingEvent *>(event));
+}
+
+void LoggingEventPool::trim(int size)
+{
+	while ((int)freeEvents.size() > size)
+	{
+		delete freeEvents.back();
+		freeEvents.pop_back();
+	}
+}
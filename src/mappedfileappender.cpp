@@ -0,0 +1,441 @@
+/***************************************************************************
+              mappedfileappender.cpp  -  class MappedFileAppender
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/mappedfileappender.h>
+#include <log4cxx/helpers/loglog.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/spi/loggingevent.h>
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_UNISTD_H) && !defined(UNICODE)
+#define LOG4CXX_MAPPED_IO
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+long MappedFileAppender::DEFAULT_SEGMENT_SIZE = 16*1024*1024;
+
+namespace
+{
+#ifdef LOG4CXX_MAPPED_IO
+	long pageSize()
+	{
+		return ::sysconf(_SC_PAGESIZE);
+	}
+
+	/** Allocate the blocks of the file from <code>start</code> to
+	<code>start + size</code>, returns false if the disk is full. */
+	bool allocate(int fd, long start, long size)
+	{
+#ifdef HAVE_POSIX_FALLOCATE
+		int rc = ::posix_fallocate(fd, (off_t)start, (off_t)size);
+		if(rc == 0)
+		{
+			return true;
+		}
+
+		if(rc == ENOSPC)
+		{
+			return false;
+		}
+#endif
+		// the file system cannot allocate, the file is only extended
+		struct stat status;
+		if(::fstat(fd, &status) != 0)
+		{
+			return false;
+		}
+
+		if((long)status.st_size >= start + size)
+		{
+			return true;
+		}
+
+		return ::ftruncate(fd, (off_t)(start + size)) == 0;
+	}
+
+	void syncDescriptor(int fd)
+	{
+#ifdef HAVE_FDATASYNC
+		::fdatasync(fd);
+#else
+		::fsync(fd);
+#endif
+	}
+#endif
+}
+
+MappedFileAppender::MappedFileAppender()
+: segmentSize(DEFAULT_SEGMENT_SIZE), mapped(false), segment(0),
+segmentStart(0), tail(0), syncedTail(0)
+{
+}
+
+MappedFileAppender::MappedFileAppender(LayoutPtr layout,
+	const tstring& fileName, bool append)
+: segmentSize(DEFAULT_SEGMENT_SIZE), mapped(false), segment(0),
+segmentStart(0), tail(0), syncedTail(0)
+{
+	this->layout = layout;
+	this->fileName = fileName;
+	this->fileAppend = append;
+	activateOptions();
+}
+
+MappedFileAppender::~MappedFileAppender()
+{
+	// closed here, the file is unmapped by this class
+	finalize();
+}
+
+void MappedFileAppender::setOption(const std::string& option,
+	const std::string& value)
+{
+	if (StringHelper::equalsIgnoreCase(option, _T("segmentsize")))
+	{
+		segmentSize = OptionConverter::toFileSize(value, DEFAULT_SEGMENT_SIZE);
+	}
+	else
+	{
+		RollingFileAppender::setOption(option, value);
+	}
+}
+
+void MappedFileAppender::activateOptions()
+{
+	// the file is closed the way it was opened
+	if(os != 0)
+	{
+		reset();
+	}
+
+#ifdef LOG4CXX_MAPPED_IO
+	mapped = true;
+	bufferedIO = false;
+	rawIO = false;
+
+	// a segment larger than the file is never used
+	long page = pageSize();
+	if(maxFileSize > 0 && segmentSize > maxFileSize)
+	{
+		segmentSize = maxFileSize;
+	}
+
+	if(segmentSize < page)
+	{
+		segmentSize = page;
+	}
+
+	segmentSize = (segmentSize + page - 1) / page * page;
+#else
+	LogLog::warn(_T("Memory mapped files are not available, appender [")
+		+ name + _T("] writes through a stream."));
+#endif
+
+	RollingFileAppender::activateOptions();
+}
+
+bool MappedFileAppender::openFile(bool append)
+{
+	if(!mapped)
+	{
+		return RollingFileAppender::openFile(append);
+	}
+
+#ifdef LOG4CXX_MAPPED_IO
+	fd = ::open(T2A(fileName.c_str()),
+		O_RDWR|O_CREAT|(append ? 0 : O_TRUNC), 0666);
+	if(fd < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+	long length = (::fstat(fd, &status) == 0) ? (long)status.st_size : 0;
+
+	// the segment ending at the page of the end of the file is
+	// mapped, it ends with zeros if the file was not truncated when
+	// it was closed
+	long page = pageSize();
+	long end = (length + page - 1) / page * page;
+	long start = end > segmentSize ? end - segmentSize : 0;
+
+	tail = length;
+	syncedTail = length;
+	bool ok = mapSegment(start);
+
+	// with a smaller segment size, the zeros may go on before it
+	while(ok)
+	{
+		while(tail > segmentStart && segment[tail - segmentStart - 1] == 0)
+		{
+			tail--;
+		}
+
+		if(tail > segmentStart || segmentStart == 0)
+		{
+			break;
+		}
+
+		syncedTail = tail;
+		ok = mapSegment(segmentStart > segmentSize ?
+			segmentStart - segmentSize : 0);
+	}
+
+	if(!ok)
+	{
+		::close(fd);
+		fd = -1;
+		return false;
+	}
+
+	syncedTail = tail;
+	unsynced = false;
+
+	// the stream is not used, os only tells the appender is ready
+	this->os = &ofs;
+	return true;
+#else
+	return false;
+#endif
+}
+
+void MappedFileAppender::closeFile()
+{
+#ifdef LOG4CXX_MAPPED_IO
+	if(mapped && fd >= 0)
+	{
+		if(segment != 0)
+		{
+			syncMapped();
+			::munmap(segment, segmentSize);
+			segment = 0;
+		}
+
+		// the rest of the last segment is given back
+		if(::ftruncate(fd, (off_t)tail) != 0)
+		{
+			errorHandler->error(_T("Unable to truncate file: ") + fileName);
+		}
+
+		if(syncPolicy != SYNC_NONE)
+		{
+			syncDescriptor(fd);
+		}
+
+		::close(fd);
+		fd = -1;
+		unsynced = false;
+	}
+#endif
+
+	RollingFileAppender::closeFile();
+}
+
+long MappedFileAppender::getFileLength()
+{
+	if(mapped && fd >= 0)
+	{
+		return tail;
+	}
+
+	return RollingFileAppender::getFileLength();
+}
+
+bool MappedFileAppender::mapSegment(long start)
+{
+#ifdef LOG4CXX_MAPPED_IO
+	if(segment != 0)
+	{
+		syncMapped();
+		::munmap(segment, segmentSize);
+		segment = 0;
+	}
+
+	if(!allocate(fd, start, segmentSize))
+	{
+		return false;
+	}
+
+	void * address = ::mmap(0, segmentSize, PROT_READ|PROT_WRITE,
+		MAP_SHARED, fd, (off_t)start);
+	if(address == MAP_FAILED)
+	{
+		return false;
+	}
+
+	segment = (char *)address;
+	segmentStart = start;
+	return true;
+#else
+	return false;
+#endif
+}
+
+void MappedFileAppender::writeMapped(const TCHAR * text, size_t length)
+{
+#ifdef LOG4CXX_MAPPED_IO
+	while(length > 0)
+	{
+		long offset = tail - segmentStart;
+		if(segment == 0 || offset >= segmentSize)
+		{
+			long start = (offset >= segmentSize) ?
+				segmentStart + segmentSize : segmentStart;
+			if(!mapSegment(start))
+			{
+				errorHandler->error(_T("Unable to map file: ") + fileName);
+				return;
+			}
+
+			offset = tail - segmentStart;
+		}
+
+		size_t room = (size_t)(segmentSize - offset);
+		size_t count = length < room ? length : room;
+
+		memcpy(segment + offset, text, count);
+		text += count;
+		length -= count;
+		tail += (long)count;
+		unsynced = true;
+	}
+#endif
+}
+
+void MappedFileAppender::syncMapped()
+{
+#ifdef LOG4CXX_MAPPED_IO
+	if(syncPolicy != SYNC_BATCH || segment == 0 || tail == syncedTail)
+	{
+		return;
+	}
+
+	// from the page of the first byte not synchronized
+	long from = syncedTail > segmentStart ? syncedTail : segmentStart;
+	from -= (from - segmentStart) % pageSize();
+
+	::msync(segment + (from - segmentStart), tail - from, MS_SYNC);
+	syncedTail = tail;
+	unsynced = false;
+#endif
+}
+
+void MappedFileAppender::subAppend(const LoggingEvent& event)
+{
+	if(!mapped || fd < 0)
+	{
+		RollingFileAppender::subAppend(event);
+		return;
+	}
+
+	text.erase();
+	layout->format(text, event);
+	subAppend(event, text);
+}
+
+void MappedFileAppender::subAppend(const LoggingEvent& event,
+	const tstring& formatted)
+{
+	if(!mapped || fd < 0)
+	{
+		RollingFileAppender::subAppend(event, formatted);
+		return;
+	}
+
+	writeMapped(formatted.data(), formatted.size());
+	syncMapped();
+
+	if(!fileName.empty() && tail >= maxFileSize)
+	{
+		rollOver();
+	}
+}
+
+void MappedFileAppender::appendBatch(const LoggingEventList& events)
+{
+	if(!mapped || fd < 0)
+	{
+		RollingFileAppender::appendBatch(events);
+		return;
+	}
+
+	if(!checkEntryConditions())
+	{
+		return;
+	}
+
+	size_t count = events.size();
+	for(size_t i = 0; i < count && fd >= 0; i++)
+	{
+		text.erase();
+		layout->format(text, *events[i]);
+		writeMapped(text.data(), text.size());
+
+		if(!fileName.empty() && tail >= maxFileSize)
+		{
+			rollOver();
+		}
+	}
+
+	if(fd >= 0)
+	{
+		syncMapped();
+	}
+}
+
+void MappedFileAppender::writeHeader()
+{
+	if(!mapped || fd < 0)
+	{
+		RollingFileAppender::writeHeader();
+		return;
+	}
+
+	if(layout != 0)
+	{
+		tostringstream header;
+		layout->appendHeader(header);
+		text = header.str();
+		writeMapped(text.data(), text.size());
+		syncMapped();
+	}
+}
+
+void MappedFileAppender::writeFooter()
+{
+	if(!mapped || fd < 0)
+	{
+		RollingFileAppender::writeFooter();
+		return;
+	}
+
+	if(layout != 0)
+	{
+		tostringstream footer;
+		layout->appendFooter(footer);
+		text = footer.str();
+		writeMapped(text.data(), text.size());
+	}
+}
@@ -0,0 +1,339 @@
+/***************************************************************************
+                          mdc.cpp  -  class MDC
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/mdc.h>
+#include <log4cxx/helpers/atomic.h>
+#include <log4cxx/helpers/criticalsection.h>
+#include <log4cxx/helpers/hazardpointer.h>
+#include <map>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+namespace
+{
+	void releaseMap(void * data)
+	{
+		((MDC::Map *)data)->releaseRef();
+	}
+
+	/** The registered keys, replaced as a whole when a key is
+	registered, so that they are looked up without locking. */
+	struct KeyTable
+	{
+		std::map<tstring, int> ids;
+		std::vector<tstring> names;
+	};
+
+	struct KeyRegistry
+	{
+		KeyRegistry() : table(new KeyTable())
+		{
+		}
+
+		/** Serializes the registrations. */
+		CriticalSection cs;
+
+		/** The current table, read under a HazardPointer. */
+		KeyTable * volatile table;
+
+		/** The tables replaced while a thread could still read them. */
+		RetiredList<KeyTable> retired;
+	};
+
+	KeyRegistry& getKeyRegistry()
+	{
+		static KeyRegistry registry;
+		return registry;
+	}
+}
+
+MDC::Map::Map() : refCount(0), unregistered(0)
+{
+}
+
+MDC::Map::Map(const Map& map)
+: refCount(0), entries(map.entries), unregistered(map.unregistered)
+{
+}
+
+void MDC::Map::addRef()
+{
+	Atomic::increment(&refCount);
+}
+
+void MDC::Map::releaseRef()
+{
+	if (Atomic::decrement(&refCount) <= 0)
+	{
+		delete this;
+	}
+}
+
+const tstring * MDC::Map::get(int key) const
+{
+	std::vector<Entry>::const_iterator it, itEnd = entries.end();
+	for (it = entries.begin(); it != itEnd; it++)
+	{
+		if (it->key == key)
+		{
+			return &it->value;
+		}
+	}
+
+	// the key may have been registered after the event was received
+	if (unregistered > 0 && key >= 0)
+	{
+		tstring name = MDC::getKeyName(key);
+		for (it = entries.begin(); it != itEnd; it++)
+		{
+			if (it->key < 0 && it->name == name)
+			{
+				return &it->value;
+			}
+		}
+	}
+
+	return 0;
+}
+
+const tstring * MDC::Map::get(const tstring& key) const
+{
+	int id = MDC::findKeyId(key);
+	if (id >= 0)
+	{
+		return get(id);
+	}
+
+	if (unregistered > 0)
+	{
+		std::vector<Entry>::const_iterator it, itEnd = entries.end();
+		for (it = entries.begin(); it != itEnd; it++)
+		{
+			if (it->key < 0 && it->name == key)
+			{
+				return &it->value;
+			}
+		}
+	}
+
+	return 0;
+}
+
+tstring MDC::Map::getKeyName(int index) const
+{
+	const Entry& entry = entries[index];
+	return entry.key < 0 ? entry.name : MDC::getKeyName(entry.key);
+}
+
+void MDC::Map::putRemote(const tstring& key, const tstring& value)
+{
+	int id = MDC::findKeyId(key);
+	if (id >= 0)
+	{
+		put(id, value);
+		return;
+	}
+
+	Entry entry;
+	entry.key = -1;
+	entry.name = key;
+	entry.value = value;
+	entries.push_back(entry);
+	unregistered++;
+}
+
+void MDC::Map::put(int key, const tstring& value)
+{
+	std::vector<Entry>::iterator it, itEnd = entries.end();
+	for (it = entries.begin(); it != itEnd; it++)
+	{
+		if (it->key == key)
+		{
+			it->value = value;
+			return;
+		}
+	}
+
+	Entry entry;
+	entry.key = key;
+	entry.value = value;
+	entries.push_back(entry);
+}
+
+void MDC::Map::remove(int key)
+{
+	std::vector<Entry>::iterator it, itEnd = entries.end();
+	for (it = entries.begin(); it != itEnd; it++)
+	{
+		if (it->key == key)
+		{
+			entries.erase(it);
+			return;
+		}
+	}
+}
+
+bool MDC::Map::isShared() const
+{
+	return Atomic::get(&refCount) > 1;
+}
+
+// static member instanciation
+ThreadSpecificData MDC::threadSpecificData(releaseMap);
+
+int MDC::findKeyId(const tstring& key)
+{
+	KeyRegistry& registry = getKeyRegistry();
+
+	// the table is not deleted while the hazard pointer protects it
+	HazardPointer hazard((void * const volatile *)&registry.table);
+	const KeyTable * table = (const KeyTable *)hazard.get();
+
+	std::map<tstring, int>::const_iterator it = table->ids.find(key);
+	return it == table->ids.end() ? -1 : it->second;
+}
+
+int MDC::getKeyId(const tstring& key)
+{
+	int id = findKeyId(key);
+	if (id >= 0)
+	{
+		return id;
+	}
+
+	KeyRegistry& registry = getKeyRegistry();
+	registry.cs.lock();
+
+	// another thread may have registered the key meanwhile
+	KeyTable * table = registry.table;
+	std::map<tstring, int>::iterator it = table->ids.find(key);
+	if (it != table->ids.end())
+	{
+		id = it->second;
+		registry.cs.unlock();
+		return id;
+	}
+
+	KeyTable * newTable = new KeyTable();
+	newTable->ids = table->ids;
+	newTable->names = table->names;
+
+	id = newTable->names.size();
+	newTable->ids[key] = id;
+	newTable->names.push_back(key);
+
+	registry.retired.retire((KeyTable *)Atomic::exchangePointer(
+		(void * volatile *)&registry.table, newTable));
+
+	registry.cs.unlock();
+	return id;
+}
+
+tstring MDC::getKeyName(int id)
+{
+	KeyRegistry& registry = getKeyRegistry();
+
+	HazardPointer hazard((void * const volatile *)&registry.table);
+	const KeyTable * table = (const KeyTable *)hazard.get();
+
+	if (id >= 0 && id < (int)table->names.size())
+	{
+		return table->names[id];
+	}
+
+	return tstring();
+}
+
+MDC::Map * MDC::getCurrentMap()
+{
+	return (Map *)threadSpecificData.GetData();
+}
+
+void MDC::setCurrentMap(MDC::Map * map)
+{
+	threadSpecificData.SetData((void *)map);
+}
+
+MDC::Map * MDC::getWritableMap()
+{
+	Map * map = getCurrentMap();
+	if (map == 0)
+	{
+		map = new Map();
+		map->addRef();
+		setCurrentMap(map);
+	}
+	else if (map->isShared())
+	{
+		// a logging event captured this version of the map
+		Map * copy = new Map(*map);
+		copy->addRef();
+		setCurrentMap(copy);
+		map->releaseRef();
+		map = copy;
+	}
+
+	return map;
+}
+
+void MDC::put(const tstring& key, const tstring& value)
+{
+	getWritableMap()->put(getKeyId(key), value);
+}
+
+tstring MDC::get(const tstring& key)
+{
+	Map * map = getCurrentMap();
+	if (map != 0)
+	{
+		const tstring * value = map->get(key);
+		if (value != 0)
+		{
+			return *value;
+		}
+	}
+
+	return tstring();
+}
+
+void MDC::remove(const tstring& key)
+{
+	// a key which is not registered has no value
+	int id = findKeyId(key);
+	if (getCurrentMap() == 0 || id < 0)
+	{
+		return;
+	}
+
+	Map * map = getWritableMap();
+	map->remove(id);
+
+	if (map->size() == 0)
+	{
+		clear();
+	}
+}
+
+void MDC::clear()
+{
+	Map * map = getCurrentMap();
+	if (map != 0)
+	{
+		setCurrentMap(0);
+		map->releaseRef();
+	}
+}
@@ -0,0 +1,302 @@
+/***************************************************************************
+              multistringmatchfilter.cpp  -  class MultiStringMatchFilter
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/varia/multistringmatchfilter.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/atomic.h>
+#include <map>
+
+using namespace log4cxx::varia;
+using namespace log4cxx::spi;
+using namespace log4cxx::helpers;
+
+tstring MultiStringMatchFilter::ACCEPT_OPTION = _T("Accept");
+tstring MultiStringMatchFilter::DENY_OPTION = _T("Deny");
+
+namespace
+{
+	inline unsigned long toCode(TCHAR c)
+	{
+#ifdef UNICODE
+		return (unsigned long)c;
+#else
+		return (unsigned char)c;
+#endif
+	}
+}
+
+/**
+The strings compiled into an Aho-Corasick automaton. An automaton is
+never modified once published.
+*/
+struct MultiStringMatchFilter::Automaton
+{
+	/** Whether each string accepts the events. */
+	std::vector<bool> accepts;
+
+	/** The trie of the strings, by state. */
+	std::vector< std::map<TCHAR, int> > gotos;
+
+	/** The longest proper suffix of each state in the trie. */
+	std::vector<int> failures;
+
+	/** The first string ending at each state, or the number of
+	strings if none does. */
+	std::vector<int> firstMatches;
+
+	/** The row of each state in #transitions, -1 if it has none. */
+	std::vector<int> rows;
+
+	/** The transitions of the characters in the alphabet,
+	ALPHABET_SIZE per row. */
+	std::vector<int> transitions;
+
+	int next(int state, TCHAR c) const
+	{
+		unsigned long code = toCode(c);
+
+		// the states without a row and the characters out of the
+		// alphabet follow the failure links
+		for (;;)
+		{
+			int row = rows[state];
+			if (row >= 0 && code < ALPHABET_SIZE)
+			{
+				return transitions[row * ALPHABET_SIZE + code];
+			}
+
+			std::map<TCHAR, int>::const_iterator found = gotos[state].find(c);
+			if (found != gotos[state].end())
+			{
+				return found->second;
+			}
+
+			if (state == 0)
+			{
+				return 0;
+			}
+
+			state = failures[state];
+		}
+	}
+};
+
+MultiStringMatchFilter::MultiStringMatchFilter()
+: automaton(0)
+{
+}
+
+MultiStringMatchFilter::~MultiStringMatchFilter()
+{
+	delete automaton;
+}
+
+void MultiStringMatchFilter::setOption(const tstring& option,
+	const tstring& value)
+{
+	if (StringHelper::equalsIgnoreCase(option, ACCEPT_OPTION))
+	{
+		addString(value, true);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, DENY_OPTION))
+	{
+		addString(value, false);
+	}
+}
+
+void MultiStringMatchFilter::addString(const tstring& stringToMatch,
+	bool accept)
+{
+	if (stringToMatch.empty())
+	{
+		return;
+	}
+
+	synchronized sync(this);
+
+	Pattern pattern;
+	pattern.text = stringToMatch;
+	pattern.accept = accept;
+	patterns.push_back(pattern);
+
+	compile();
+}
+
+void MultiStringMatchFilter::clear()
+{
+	synchronized sync(this);
+
+	patterns.clear();
+	compile();
+}
+
+void MultiStringMatchFilter::compile()
+{
+	int none = (int)patterns.size();
+	Automaton * compiled = 0;
+
+	if (none > 0)
+	{
+		compiled = new Automaton;
+		compiled->gotos.assign(1, std::map<TCHAR, int>());
+		compiled->firstMatches.assign(1, none);
+
+		// the trie, each state keeps the first string ending there
+		int i;
+		for (i = 0; i < none; i++)
+		{
+			const tstring& text = patterns[i].text;
+			int state = 0;
+
+			compiled->accepts.push_back(patterns[i].accept);
+
+			tstring::const_iterator it, itEnd = text.end();
+			for (it = text.begin(); it != itEnd; it++)
+			{
+				std::map<TCHAR, int>& gotos = compiled->gotos[state];
+				std::map<TCHAR, int>::iterator found = gotos.find(*it);
+				if (found != gotos.end())
+				{
+					state = found->second;
+				}
+				else
+				{
+					int newState = (int)compiled->gotos.size();
+					gotos[*it] = newState;
+					compiled->gotos.push_back(std::map<TCHAR, int>());
+					compiled->firstMatches.push_back(none);
+					state = newState;
+				}
+			}
+
+			if (i < compiled->firstMatches[state])
+			{
+				compiled->firstMatches[state] = i;
+			}
+		}
+
+		// the failure links, breadth first so that the failure of a
+		// state is complete before the state is visited, and the rows
+		// go to the states closest to the root
+		int stateCount = (int)compiled->gotos.size();
+		int rowCount = 0;
+		compiled->failures.assign(stateCount, 0);
+		compiled->rows.assign(stateCount, -1);
+
+		std::vector<int> queue;
+		queue.reserve(stateCount);
+		queue.push_back(0);
+
+		for (size_t head = 0; head < queue.size(); head++)
+		{
+			int state = queue[head];
+			int failure = compiled->failures[state];
+			std::vector<int>& firstMatches = compiled->firstMatches;
+
+			if (firstMatches[failure] < firstMatches[state])
+			{
+				firstMatches[state] = firstMatches[failure];
+			}
+
+			int row = -1;
+			if (rowCount < DENSE_STATE_COUNT)
+			{
+				row = rowCount++;
+				compiled->transitions.resize(rowCount * ALPHABET_SIZE);
+
+				for (int c = 0; c < ALPHABET_SIZE; c++)
+				{
+					compiled->transitions[row * ALPHABET_SIZE + c] =
+						(state == 0) ? 0 : compiled->next(failure, (TCHAR)c);
+				}
+			}
+
+			const std::map<TCHAR, int>& gotos = compiled->gotos[state];
+			std::map<TCHAR, int>::const_iterator it, itEnd = gotos.end();
+			for (it = gotos.begin(); it != itEnd; it++)
+			{
+				int child = it->second;
+				compiled->failures[child] =
+					(state == 0) ? 0 : compiled->next(failure, it->first);
+				queue.push_back(child);
+
+				unsigned long code = toCode(it->first);
+				if (row >= 0 && code < ALPHABET_SIZE)
+				{
+					compiled->transitions[row * ALPHABET_SIZE + code] = child;
+				}
+			}
+
+			compiled->rows[state] = row;
+		}
+	}
+
+	// the events being decided keep the previous automaton
+	retiredAutomata.retire((Automaton *)Atomic::exchangePointer(
+		(void * volatile *)&automaton, compiled));
+}
+
+int MultiStringMatchFilter::decide(const LoggingEvent& event)
+{
+	const tstring& msg = event.getRenderedMessage();
+
+	if (msg.empty())
+	{
+		return Filter::NEUTRAL;
+	}
+
+	HazardPointer hazard((void * const volatile *)&automaton);
+	const Automaton * compiled = (const Automaton *)hazard.get();
+
+	if (compiled == 0)
+	{
+		return Filter::NEUTRAL;
+	}
+
+	int none = (int)compiled->accepts.size();
+	const int * rows = &compiled->rows[0];
+	const int * table = &compiled->transitions[0];
+	const int * matches = &compiled->firstMatches[0];
+	int state = 0;
+	int first = none;
+
+	tstring::const_iterator it, itEnd = msg.end();
+	for (it = msg.begin(); it != itEnd; it++)
+	{
+		unsigned long code = toCode(*it);
+		int row = rows[state];
+		state = (row >= 0 && code < ALPHABET_SIZE) ?
+			table[row * ALPHABET_SIZE + code] : compiled->next(state, *it);
+
+		if (matches[state] < first)
+		{
+			first = matches[state];
+			if (first == 0)
+			{
+				// no string can take precedence
+				break;
+			}
+		}
+	}
+
+	if (first == none)
+	{
+		return Filter::NEUTRAL;
+	}
+
+	return compiled->accepts[first] ? Filter::ACCEPT : Filter::DENY;
+}
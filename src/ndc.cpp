@@ -15,80 +15,150 @@
  ***************************************************************************/
 
 #include <log4cxx/ndc.h>
+#include <log4cxx/helpers/atomic.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 
-NDC::DiagnosticContext::DiagnosticContext(const tstring& message, 
-	const DiagnosticContext * parent)
-	: message(message)
+namespace
+{
+	void releaseContext(void * data)
+	{
+		((NDC::DiagnosticContext *)data)->releaseRef();
+	}
+}
+
+NDC::DiagnosticContext::DiagnosticContext(const tstring& message,
+	DiagnosticContext * parent)
+	: refCount(0), message(message), parent(parent), fullMessage(0)
 {
 	if (parent != 0)
 	{
-		fullMessage = parent->fullMessage + ' ' + message;
-	} 
-	else 
+		parent->addRef();
+		depth = parent->depth + 1;
+	}
+	else
 	{
-		fullMessage = message;
+		depth = 1;
 	}
 }
 
-// static member instanciation
-ThreadSpecificData NDC::threadSpecificData;
-
-NDC::Stack * NDC::getCurrentThreadStack()
+NDC::DiagnosticContext::~DiagnosticContext()
 {
-	return (Stack *)threadSpecificData.GetData();
+	if (fullMessage != &message)
+	{
+		delete fullMessage;
+	}
+
+	if (parent != 0)
+	{
+		parent->releaseRef();
+	}
 }
 
-void NDC::setCurrentThreadStack(NDC::Stack * stack)
+void NDC::DiagnosticContext::addRef()
 {
-	threadSpecificData.SetData((void *)stack); 
+	Atomic::increment(&refCount);
 }
 
-void NDC::clear()
+void NDC::DiagnosticContext::releaseRef()
 {
-	Stack * stack = getCurrentThreadStack();    
-	if(stack != 0)
+	if (Atomic::decrement(&refCount) <= 0)
 	{
-		delete stack;
-		setCurrentThreadStack(0);
-	} 
+		delete this;
+	}
 }
 
-NDC::Stack * NDC::cloneStack()
+const tstring& NDC::DiagnosticContext::getFullMessage()
 {
-	Stack * stack = getCurrentThreadStack();
-	if(stack != 0)
+	tstring * full = (tstring *)Atomic::getPointer(
+		(void * const volatile *)&fullMessage);
+	if (full != 0)
+	{
+		return *full;
+	}
+
+	if (parent == 0)
 	{
-		return new Stack(*stack);
+		full = &message;
 	}
 	else
 	{
-		return new Stack();
+		const tstring& parentMessage = parent->getFullMessage();
+		full = new tstring;
+		full->reserve(parentMessage.size() + 1 + message.size());
+		full->append(parentMessage);
+		full->append(1, _T(' '));
+		full->append(message);
 	}
+
+	// frames are shared between threads: the first string published
+	// wins, the others are discarded.
+	if (!Atomic::compareAndSetPointer((void * volatile *)&fullMessage,
+		0, full))
+	{
+		if (full != &message)
+		{
+			delete full;
+		}
+		full = (tstring *)Atomic::getPointer(
+			(void * const volatile *)&fullMessage);
+	}
+
+	return *full;
+}
+
+// static member instanciation
+ThreadSpecificData NDC::threadSpecificData(releaseContext);
+
+NDC::DiagnosticContext * NDC::getCurrentContext()
+{
+	return (DiagnosticContext *)threadSpecificData.GetData();
+}
+
+void NDC::setCurrentContext(NDC::DiagnosticContext * context)
+{
+	threadSpecificData.SetData((void *)context);
+}
+
+void NDC::clear()
+{
+	DiagnosticContext * context = getCurrentContext();
+	if(context != 0)
+	{
+		setCurrentContext(0);
+		context->releaseRef();
+	}
+}
+
+NDC::Stack * NDC::cloneStack()
+{
+	// the frames are immutable, the clone shares them
+	return new Stack(getCurrentContext());
 }
 
 void NDC::inherit(NDC::Stack * stack)
 {
 	if(stack != 0)
 	{
-		Stack * oldStack = getCurrentThreadStack();
-		if(oldStack != 0)
+		DiagnosticContext * context = stack->top;
+		if(context != 0)
 		{
-			delete oldStack;
+			context->addRef();
 		}
-	
-		setCurrentThreadStack(stack);
+
+		clear();
+		setCurrentContext(context);
+		delete stack;
 	}
 }
 
 tstring NDC::get()
 {
-	Stack * stack = getCurrentThreadStack();
-	if(stack != 0 && !stack->empty())
+	DiagnosticContext * context = getCurrentContext();
+	if(context != 0)
 	{
-		return stack->top().fullMessage;
+		return context->getFullMessage();
 	}
 	else
 	{
@@ -98,29 +168,32 @@ tstring NDC::get()
 
 int NDC::getDepth()
 {
-	Stack * stack = getCurrentThreadStack();
-	if(stack == 0)
+	DiagnosticContext * context = getCurrentContext();
+	if(context == 0)
 	{
 		return 0;
 	}
 	else
 	{
-		return stack->size();
+		return context->getDepth();
 	}
 }
 
 tstring NDC::pop()
 {
-	Stack * stack = getCurrentThreadStack();
-	if(stack != 0 && !stack->empty())
+	DiagnosticContext * context = getCurrentContext();
+	if(context != 0)
 	{
-		tstring message = stack->top().message;
-		stack->pop();
-		if (stack->empty())
+		tstring message = context->getMessage();
+
+		DiagnosticContext * parent = context->getParent();
+		if (parent != 0)
 		{
-			delete stack;
-			setCurrentThreadStack(0);
+			parent->addRef();
 		}
+		setCurrentContext(parent);
+		context->releaseRef();
+
 		return message;
 	}
 	else
@@ -131,10 +204,10 @@ tstring NDC::pop()
 
 tstring NDC::peek()
 {
-	Stack * stack = getCurrentThreadStack();
-	if(stack != 0 && !stack->empty())
+	DiagnosticContext * context = getCurrentContext();
+	if(context != 0)
 	{
-		return stack->top().message;
+		return context->getMessage();
 	}
 	else
 	{
@@ -144,31 +217,19 @@ tstring NDC::peek()
 
 void NDC::push(const tstring& message)
 {
-	Stack * stack = getCurrentThreadStack();
-
-	if (stack == 0)
-	{
-		stack = new Stack;
-		setCurrentThreadStack(stack);
-		stack->push(DiagnosticContext(message, 0));
-	}
-	else if (stack->empty())
-	{
-		stack->push(DiagnosticContext(message, 0));
-	}
-	else
+	// the new frame holds its own reference on its parent, the
+	// reference of the thread moves to the new frame.
+	DiagnosticContext * parent = getCurrentContext();
+	DiagnosticContext * context = new DiagnosticContext(message, parent);
+	context->addRef();
+	setCurrentContext(context);
+	if (parent != 0)
 	{
-		DiagnosticContext& parent = stack->top();
-		stack->push(DiagnosticContext(message, &parent));
+		parent->releaseRef();
 	}
 }
 
 void NDC::remove()
 {
-	Stack * stack = getCurrentThreadStack();
-	if(stack != 0)
-	{
-		delete stack;
-		setCurrentThreadStack(0);
-	}
+	clear();
 }
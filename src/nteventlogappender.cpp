@@ -103,6 +103,9 @@ NTEventLogAppender::~NTEventLogAppender()
 
 void NTEventLogAppender::close()
 {
+	// the filters append what they hold back while the appender is open
+	closeFilters();
+
 	if (hEventLog != NULL)
 	{
 		::DeregisterEventSource(hEventLog);
@@ -151,6 +154,9 @@ void NTEventLogAppender::activateOptions()
 
 	close();
 
+	// the filters were detached by close
+	AppenderSkeleton::activateOptions();
+
 	// current user security identifier
 	CCtUserSIDHelper::GetCurrentUserSID(&pCurrentUserSID);
 
@@ -15,10 +15,7 @@
  ***************************************************************************/
  
 #include <log4cxx/helpers/objectimpl.h>
-
-#ifdef WIN32
-#include <windows.h>
-#endif
+#include <log4cxx/helpers/atomic.h>
 
 using namespace log4cxx::helpers;
 
@@ -32,39 +29,15 @@ ObjectImpl::~ObjectImpl()
 
 void ObjectImpl::addRef()
 {
-#ifdef HAVE_PTHREAD_H
-	refCs.lock();
-	ref++;
-	refCs.unlock();
-#elif defined(WIN32)
-	::InterlockedIncrement((long *)&ref);
-#else
-	ref++;
-#endif
+	Atomic::increment(&ref);
 }
 
 void ObjectImpl::releaseRef()
 {
-#ifdef HAVE_PTHREAD_H
-	refCs.lock();
-	ref--;
-	if (ref <= 0)
-	{
-		delete this;
-	}
-	refCs.unlock();
-#elif defined(WIN32)
-	if (::InterlockedDecrement((long *)&ref) <= 0)
-	{
-		delete this;
-	}
-#else
-	ref--;
-	if (ref <= 0)
+	if (Atomic::decrement(&ref) <= 0)
 	{
 		delete this;
 	}
-#endif
 }
 
 void ObjectImpl::lock()
@@ -94,3 +94,14 @@ void PatternConverter::spacePad(tostream& sbuf, int length)
 	}
 }
 
+void PatternConverter::compile(PatternInstruction& instruction)
+{
+	instruction.opcode = GENERIC_OP;
+	instruction.min = min;
+	instruction.max = max;
+	instruction.leftAlign = leftAlign;
+	instruction.option = 0;
+	instruction.literal.erase();
+	instruction.dateFormat = 0;
+	instruction.converter = this;
+}
@@ -18,11 +18,111 @@
 #include <log4cxx/helpers/patternparser.h>
 #include <log4cxx/helpers/patternconverter.h>
 #include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/dateformat.h>
+#include <log4cxx/helpers/relativetimedateformat.h>
+#include <log4cxx/helpers/hazardpointer.h>
+#include <log4cxx/helpers/atomic.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/level.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 using namespace log4cxx::spi;
 
+namespace
+{
+	void deleteBuffer(void * data)
+	{
+		delete (tstring *)data;
+	}
+
+	void appendInt(tstring& output, unsigned long value)
+	{
+		TCHAR digits[24];
+		TCHAR * p = digits + 24;
+
+		do
+		{
+			*--p = (TCHAR)(_T('0') + value % 10);
+			value /= 10;
+		}
+		while (value != 0);
+
+		output.append(p, digits + 24 - p);
+	}
+
+	void appendInt(tstring& output, long value)
+	{
+		if (value < 0)
+		{
+			output += _T('-');
+			appendInt(output, (unsigned long)-value);
+		}
+		else
+		{
+			appendInt(output, (unsigned long)value);
+		}
+	}
+
+	void appendLoggerName(tstring& output, const tstring& name, int precision)
+	{
+		if (precision > 0)
+		{
+			// keep the last 'precision' components of the name
+			tstring::size_type len = name.length();
+			tstring::size_type end = len - 1;
+			for (int i = precision; i > 0; i--)
+			{
+				end = name.rfind(_T('.'), end - 1);
+				if (end == tstring::npos)
+				{
+					output.append(name);
+					return;
+				}
+			}
+			output.append(name, end + 1, len - (end + 1));
+		}
+		else
+		{
+			output.append(name);
+		}
+	}
+
+	// apply the min/max/leftAlign modifiers to the field appended
+	// from 'start'
+	void pad(tstring& output, tstring::size_type start,
+		const PatternInstruction& instruction)
+	{
+		int len = (int)(output.size() - start);
+
+		if (len > instruction.max)
+		{
+			output.erase(start, len - instruction.max);
+		}
+		else if (len < instruction.min)
+		{
+			if (instruction.leftAlign)
+			{
+				output.append(instruction.min - len, _T(' '));
+			}
+			else
+			{
+				output.insert(start, instruction.min - len, _T(' '));
+			}
+		}
+	}
+}
+
+struct PatternLayout::Program
+{
+	/** The converters, which own the date formats of the
+	instructions. */
+	PatternConverterPtr head;
+	std::vector<PatternInstruction> instructions;
+};
+
+ThreadSpecificData PatternLayout::buffer(deleteBuffer);
+
 /** Default pattern string for log output. Currently set to the
 string <b>"%m%n"</b> which just prints the application supplied
 message. */
@@ -35,18 +135,24 @@ tstring PatternLayout::TTCC_CONVERSION_PATTERN = _T("%r [%t] %p %c %x - %m%n");
 int PatternLayout::BUF_SIZE = 256;
 int PatternLayout::MAX_CAPACITY = 1024;
 
-PatternLayout::PatternLayout()
+PatternLayout::PatternLayout() : program(0)
 {
 }
 
 /**
 Constructs a PatternLayout using the supplied conversion pattern.
 */
-PatternLayout::PatternLayout(const tstring& pattern) : pattern(pattern)
+PatternLayout::PatternLayout(const tstring& pattern)
+: pattern(pattern), program(0)
 {
 	activateOptions();
 }
 
+PatternLayout::~PatternLayout()
+{
+	delete program;
+}
+
 void PatternLayout::setConversionPattern(const tstring& conversionPattern)
 {
 	pattern = conversionPattern;
@@ -55,12 +161,121 @@ void PatternLayout::setConversionPattern(const tstring& conversionPattern)
 
 void PatternLayout::format(tostream& output, const spi::LoggingEvent& event)
 {
-	PatternConverterPtr c = head;
-	
-	while(c != 0)
+	tstring * buf = (tstring *)buffer.GetData();
+	if (buf == 0)
+	{
+		buf = new tstring;
+		buf->reserve(BUF_SIZE);
+		buffer.SetData(buf);
+	}
+
+	buf->erase();
+	format(*buf, event);
+	output.write(buf->data(), buf->size());
+
+	// do not keep the memory of an exceptionally large event
+	if ((int)buf->capacity() > MAX_CAPACITY)
 	{
-		c->format(output, event);
-		c = c->next;
+		tstring().swap(*buf);
+		buf->reserve(BUF_SIZE);
+	}
+}
+
+void PatternLayout::format(tstring& output, const spi::LoggingEvent& event)
+{
+	// the program is not deleted while the hazard pointer protects it
+	HazardPointer hazard((void * const volatile *)&program);
+	Program * current = (Program *)hazard.get();
+	if (current == 0)
+	{
+		return;
+	}
+
+	std::vector<PatternInstruction>::const_iterator it,
+		itEnd = current->instructions.end();
+
+	for (it = current->instructions.begin(); it != itEnd; it++)
+	{
+		const PatternInstruction& instruction = *it;
+		tstring::size_type start = output.size();
+
+		switch (instruction.opcode)
+		{
+		case PatternConverter::LITERAL_OP:
+			output.append(instruction.literal);
+			continue;
+		case PatternConverter::MESSAGE_OP:
+			output.append(event.getRenderedMessage());
+			break;
+		case PatternConverter::DATE_OP:
+			instruction.dateFormat->format(output, event.getTimeStamp(),
+				event.getMicroseconds());
+			break;
+		case PatternConverter::LEVEL_OP:
+			output.append(event.getLevel().toString());
+			break;
+		case PatternConverter::LOGGER_OP:
+			appendLoggerName(output, event.getLoggerName(), instruction.option);
+			break;
+		case PatternConverter::THREAD_OP:
+			output.append(event.getThreadName());
+			break;
+		case PatternConverter::RELATIVE_TIME_OP:
+			RelativeTimeDateFormat::appendElapsed(output,
+				LoggingEvent::getStartTime(),
+				LoggingEvent::getStartMicroseconds(),
+				event.getTimeStamp(), event.getMicroseconds());
+			break;
+		case PatternConverter::NDC_OP:
+			output.append(event.getNDC());
+			break;
+		case PatternConverter::MDC_OP:
+			output.append(event.getMDC(instruction.option));
+			break;
+		case PatternConverter::FULL_LOCATION_OP:
+		{
+			const TCHAR * fileName = event.getFileName();
+			if (fileName != 0)
+			{
+				output.append(fileName);
+				output += _T('(');
+				appendInt(output, (long)event.getLine());
+				output += _T(')');
+			}
+			break;
+		}
+		case PatternConverter::FILE_OP:
+		{
+			const TCHAR * fileName = event.getFileName();
+			if (fileName != 0)
+			{
+				output.append(fileName);
+			}
+			break;
+		}
+		case PatternConverter::METHOD_OP:
+		{
+			const TCHAR * functionName = event.getFunctionName();
+			if (functionName != 0)
+			{
+				output.append(functionName);
+			}
+			break;
+		}
+		case PatternConverter::LINE_OP:
+			appendInt(output, (long)event.getLine());
+			break;
+		default:
+		{
+			// the converter applies the modifiers itself
+			tostringstream os;
+			instruction.converter->format(os, event);
+			output.append(os.str());
+			continue;
+		}
+		}
+
+		pad(output, start, instruction);
 	}
 }
 
@@ -84,7 +299,22 @@ void PatternLayout::activateOptions()
 		pattern = DEFAULT_CONVERSION_PATTERN;
 	}
 
-	head = createPatternParser(pattern);
+	Program * newProgram = new Program();
+	newProgram->head = createPatternParser(pattern);
+
+	std::vector<PatternInstruction>& instructions = newProgram->instructions;
+	for (PatternConverter * c = newProgram->head.get(); c != 0;
+		c = c->next.get())
+	{
+		instructions.push_back(PatternInstruction());
+		c->compile(instructions.back());
+	}
+
+	// the events being formatted keep the previous program
+	synchronized sync(this);
+
+	retiredPrograms.retire((Program *)Atomic::exchangePointer(
+		(void * volatile *)&program, newProgram));
 }
 
 
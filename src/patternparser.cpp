@@ -19,10 +19,12 @@
 #include <log4cxx/helpers/absolutetimedateformat.h>
 #include <log4cxx/helpers/iso8601dateformat.h>
 #include <log4cxx/helpers/datetimedateformat.h>
+#include <log4cxx/helpers/relativetimedateformat.h>
 #include <log4cxx/helpers/stringhelper.h>
 #include <log4cxx/spi/loggingevent.h>
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/level.h>
+#include <log4cxx/mdc.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -40,7 +42,7 @@ enum ParserState
 	MAX_STATE,
 
 	FULL_LOCATION_CONVERTER,
-	//METHOD_LOCATION_CONVERTER = 1001;
+	METHOD_LOCATION_CONVERTER,
 	CLASS_LOCATION_CONVERTER,
 	LINE_LOCATION_CONVERTER,
 	FILE_LOCATION_CONVERTER,
@@ -289,6 +291,11 @@ void PatternParser::finalizeConverter(TCHAR c)
 		//formattingInfo.dump();
 		currentLiteral.str(_T(""));
 		break;
+	case _T('M'):
+		pc = new LocationPatternConverter(formattingInfo,
+			METHOD_LOCATION_CONVERTER);
+		currentLiteral.str(_T(""));
+		break;
 	case _T('m'):
 		pc = new BasicPatternConverter(formattingInfo, MESSAGE_CONVERTER);
 		//LogLog.debug("MESSAGE converter.");
@@ -376,10 +383,16 @@ void PatternParser::BasicPatternConverter::convert(tostream& sbuf, const spi::Lo
 	switch(type)
 	{
 	case RELATIVE_TIME_CONVERTER:
-		sbuf << (event.getTimeStamp() - LoggingEvent::getStartTime());
+	{
+		tstring s;
+		RelativeTimeDateFormat::appendElapsed(s,
+			LoggingEvent::getStartTime(), LoggingEvent::getStartMicroseconds(),
+			event.getTimeStamp(), event.getMicroseconds());
+		sbuf << s;
 		break;
+	}
 	case THREAD_CONVERTER:
-		sbuf << event.getThreadId();
+		sbuf << event.getThreadName();
 		break;
 	case LEVEL_CONVERTER:
 		sbuf << event.getLevel().toString();
@@ -393,6 +406,30 @@ void PatternParser::BasicPatternConverter::convert(tostream& sbuf, const spi::Lo
 	}
 }
 
+void PatternParser::BasicPatternConverter::compile(PatternInstruction& instruction)
+{
+	PatternConverter::compile(instruction);
+
+	switch(type)
+	{
+	case RELATIVE_TIME_CONVERTER:
+		instruction.opcode = RELATIVE_TIME_OP;
+		break;
+	case THREAD_CONVERTER:
+		instruction.opcode = THREAD_OP;
+		break;
+	case LEVEL_CONVERTER:
+		instruction.opcode = LEVEL_OP;
+		break;
+	case NDC_CONVERTER:
+		instruction.opcode = NDC_OP;
+		break;
+	case MESSAGE_CONVERTER:
+		instruction.opcode = MESSAGE_OP;
+		break;
+	}
+}
+
 PatternParser::LiteralPatternConverter::LiteralPatternConverter(const tstring& value)
 : literal(value)
 {
@@ -408,6 +445,13 @@ void PatternParser::LiteralPatternConverter::convert(tostream& sbuf, const spi::
 	sbuf << literal;
 }
 
+void PatternParser::LiteralPatternConverter::compile(PatternInstruction& instruction)
+{
+	PatternConverter::compile(instruction);
+	instruction.opcode = LITERAL_OP;
+	instruction.literal = literal;
+}
+
 PatternParser::DatePatternConverter::DatePatternConverter(const FormattingInfo& formattingInfo, DateFormat * df)
 : PatternConverter(formattingInfo), df(df)
 {
@@ -420,17 +464,31 @@ PatternParser::DatePatternConverter::~DatePatternConverter()
 
 void PatternParser::DatePatternConverter::convert(tostream& sbuf, const spi::LoggingEvent& event)
 {
-	df->format(sbuf, event.getTimeStamp());
+	df->format(sbuf, event.getTimeStamp(), event.getMicroseconds());
+}
+
+void PatternParser::DatePatternConverter::compile(PatternInstruction& instruction)
+{
+	PatternConverter::compile(instruction);
+	instruction.opcode = DATE_OP;
+	instruction.dateFormat = df;
 }
 
 PatternParser::MDCPatternConverter::MDCPatternConverter(const FormattingInfo& formattingInfo, const tstring& key)
-: PatternConverter(formattingInfo), key(key)
+: PatternConverter(formattingInfo), key(key), keyId(MDC::getKeyId(key))
 {
 }
 
 void PatternParser::MDCPatternConverter::convert(tostream& sbuf, const spi::LoggingEvent& event)
 {
-	sbuf << event.getNDC();
+	sbuf << event.getMDC(keyId);
+}
+
+void PatternParser::MDCPatternConverter::compile(PatternInstruction& instruction)
+{
+	PatternConverter::compile(instruction);
+	instruction.opcode = MDC_OP;
+	instruction.option = keyId;
 }
 
 
@@ -444,21 +502,47 @@ void PatternParser::LocationPatternConverter::convert(tostream& sbuf, const spi:
 	switch(type)
 	{
 	case FULL_LOCATION_CONVERTER:
-		if (event.getFile() != 0)
+		if (event.getFileName() != 0)
 		{
-			sbuf << event.getFile() << _T("(") << event.getLine() << _T(")");
+			sbuf << event.getFileName() << _T("(") << event.getLine() << _T(")");
 		}
 		break;
 	case LINE_LOCATION_CONVERTER:
 		sbuf << event.getLine();
 		break;
 	case FILE_LOCATION_CONVERTER:
-		if (event.getFile() != 0)
+		if (event.getFileName() != 0)
 		{
-			USES_CONVERSION;
-			sbuf << A2T(event.getFile());
+			sbuf << event.getFileName();
 		}
 		break;
+	case METHOD_LOCATION_CONVERTER:
+		if (event.getFunctionName() != 0)
+		{
+			sbuf << event.getFunctionName();
+		}
+		break;
+	}
+}
+
+void PatternParser::LocationPatternConverter::compile(PatternInstruction& instruction)
+{
+	PatternConverter::compile(instruction);
+
+	switch(type)
+	{
+	case FULL_LOCATION_CONVERTER:
+		instruction.opcode = FULL_LOCATION_OP;
+		break;
+	case LINE_LOCATION_CONVERTER:
+		instruction.opcode = LINE_OP;
+		break;
+	case FILE_LOCATION_CONVERTER:
+		instruction.opcode = FILE_OP;
+		break;
+	case METHOD_LOCATION_CONVERTER:
+		instruction.opcode = METHOD_OP;
+		break;
 	}
 }
 
@@ -497,5 +581,9 @@ void PatternParser::CategoryPatternConverter::convert(tostream& sbuf, const spi:
 	}
 }
 
-
-
+void PatternParser::CategoryPatternConverter::compile(PatternInstruction& instruction)
+{
+	PatternConverter::compile(instruction);
+	instruction.opcode = LOGGER_OP;
+	instruction.option = precision;
+}
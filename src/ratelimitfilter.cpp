@@ -0,0 +1,293 @@
+/***************************************************************************
+              ratelimitfilter.cpp  -  class RateLimitFilter
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/varia/ratelimitfilter.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/spi/callsite.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/atomic.h>
+#include <log4cxx/appender.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <string.h>
+
+using namespace log4cxx;
+using namespace log4cxx::varia;
+using namespace log4cxx::spi;
+using namespace log4cxx::helpers;
+
+tstring RateLimitFilter::KEY_OPTION = _T("Key");
+tstring RateLimitFilter::RATE_OPTION = _T("Rate");
+tstring RateLimitFilter::BURST_OPTION = _T("Burst");
+tstring RateLimitFilter::SAMPLE_RATE_OPTION = _T("SampleRate");
+
+ThreadSpecificData RateLimitFilter::reporting;
+
+RateLimitFilter::RateLimitFilter()
+: nextFlush(0), keyByLogger(false), rate(100), burst(100), sampleRate(0)
+{
+	slots = new Slot[MAX_KEYS];
+	memset(slots, 0, MAX_KEYS * sizeof(Slot));
+	memset(&overflow, 0, sizeof(Slot));
+}
+
+RateLimitFilter::~RateLimitFilter()
+{
+	delete [] slots;
+}
+
+void RateLimitFilter::setOption(const tstring& option,
+	const tstring& value)
+{
+	if (StringHelper::equalsIgnoreCase(option, KEY_OPTION))
+	{
+		keyByLogger = StringHelper::equalsIgnoreCase(value, _T("logger"));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, RATE_OPTION))
+	{
+		setRate(OptionConverter::toInt(value, rate));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, BURST_OPTION))
+	{
+		setBurst(OptionConverter::toInt(value, burst));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, SAMPLE_RATE_OPTION))
+	{
+		setSampleRate(OptionConverter::toInt(value, sampleRate));
+	}
+}
+
+RateLimitFilter::Slot * RateLimitFilter::findSlot(void * key,
+	const LoggingEvent& event)
+{
+	unsigned long hash = (unsigned long)key;
+	hash = (hash >> 4) * 2654435761UL;
+
+	long now = event.getRelativeTime();
+	Slot * stale = 0;
+	void * staleKey = 0;
+
+	for (int i = 0; i < MAX_PROBES; i++)
+	{
+		Slot * slot = slots + ((hash + i) & (MAX_KEYS - 1));
+		void * current = Atomic::getPointer(&slot->key);
+
+		if (current == key)
+		{
+			return slot;
+		}
+
+		if (current == 0)
+		{
+			// claim a free slot, a zero state is a full bucket
+			if (Atomic::compareAndSetPointer(&slot->key, 0, key))
+			{
+				stale = slot;
+				break;
+			}
+
+			if (Atomic::getPointer(&slot->key) == key)
+			{
+				return slot;
+			}
+
+			continue;
+		}
+
+		// a key whose bucket was refilled and which has nothing to
+		// report is as good as a free slot
+		long used = Atomic::get(&slot->used);
+		long elapsed = (long)((unsigned long)now -
+			(unsigned long)Atomic::get(&slot->lastRefill));
+		if (stale == 0 && Atomic::get(&slot->suppressed) == 0 &&
+			elapsed > used / rate)
+		{
+			stale = slot;
+			staleKey = current;
+		}
+	}
+
+	if (stale == 0 || (staleKey != 0 &&
+		!Atomic::compareAndSetPointer(&stale->key, staleKey, key)))
+	{
+		return &overflow;
+	}
+
+	Atomic::set(&stale->used, 0);
+	Atomic::set(&stale->lastRefill, now);
+	Atomic::set(&stale->overLimit, 0);
+	Atomic::setPointer((void * volatile *)&stale->callSite,
+		key == (void *)event.getCallSite() ? event.getCallSite() : 0);
+	Atomic::setPointer((void * volatile *)&stale->logger,
+		event.getLogger().p);
+	return stale;
+}
+
+int RateLimitFilter::decide(const LoggingEvent& event)
+{
+	if (reporting.GetData() == this)
+	{
+		// the summary of this filter
+		return Filter::NEUTRAL;
+	}
+
+	// the clock was read by the event
+	long now = event.getRelativeTime();
+
+	// once a second, one event reports the keys which went quiet
+	long next = Atomic::get(&nextFlush);
+	if (now - next >= 0 &&
+		Atomic::compareAndSet(&nextFlush, next, now + 1000))
+	{
+		flush();
+	}
+
+	void * key = keyByLogger ? 0 : event.getCallSite();
+	if (key == 0)
+	{
+		key = event.getLogger().p;
+	}
+
+	Slot * slot = findSlot(key, event);
+	long capacity = (long)burst * 1000;
+
+	// one thread refills the bucket for the elapsed milliseconds
+	long last = Atomic::get(&slot->lastRefill);
+	long elapsed = (long)((unsigned long)now - (unsigned long)last);
+	if (elapsed > 0 && Atomic::compareAndSet(&slot->lastRefill, last, now))
+	{
+		long maxElapsed = capacity / rate + 1;
+		long refill = (elapsed < maxElapsed ? elapsed : maxElapsed) * rate;
+		long used;
+		do
+		{
+			used = Atomic::get(&slot->used);
+		}
+		while (used > 0 && !Atomic::compareAndSet(&slot->used, used,
+			used > refill ? used - refill : 0));
+	}
+
+	// take a token
+	bool taken = false;
+	long used = Atomic::get(&slot->used);
+	while (used + 1000 <= capacity)
+	{
+		if (Atomic::compareAndSet(&slot->used, used, used + 1000))
+		{
+			taken = true;
+			break;
+		}
+
+		used = Atomic::get(&slot->used);
+	}
+
+	if (taken)
+	{
+		// the summary goes before the event
+		report(slot);
+		return Filter::NEUTRAL;
+	}
+
+	if (sampleRate > 0 &&
+		Atomic::increment(&slot->overLimit) % sampleRate == 0)
+	{
+		return Filter::NEUTRAL;
+	}
+
+	Atomic::setPointer((void * volatile *)&slot->logger,
+		event.getLogger().p);
+	Atomic::setPointer((void * volatile *)&slot->level,
+		(void *)&event.getLevel());
+	Atomic::increment(&slot->suppressed);
+	return Filter::DENY;
+}
+
+void RateLimitFilter::flush()
+{
+	for (int i = 0; i < MAX_KEYS; i++)
+	{
+		report(slots + i);
+	}
+
+	report(&overflow);
+}
+
+void RateLimitFilter::report(Slot * slot)
+{
+	Appender * owner = getOwner();
+	if (owner == 0 || Atomic::get(&slot->suppressed) == 0)
+	{
+		return;
+	}
+
+	long suppressed = Atomic::exchange(&slot->suppressed, 0);
+	if (suppressed <= 0)
+	{
+		return;
+	}
+
+	LoggerPtr logger = (Logger *)Atomic::getPointer(
+		(void * const volatile *)&slot->logger);
+	const Level * level = (const Level *)Atomic::getPointer(
+		(void * const volatile *)&slot->level);
+	CallSite * callSite = (CallSite *)Atomic::getPointer(
+		(void * const volatile *)&slot->callSite);
+
+	tostringstream message;
+	message << _T("Suppressed ") << suppressed
+		<< (suppressed == 1 ? _T(" event") : _T(" events"));
+
+	if (slot == &overflow)
+	{
+		message << _T(" of the statements beyond the capacity of the")
+			<< _T(" filter.");
+	}
+	else if (callSite != 0 && callSite->getFileName() != 0)
+	{
+		message << _T(" from ") << callSite->getFileName()
+			<< _T("(") << callSite->line << _T(").");
+	}
+	else
+	{
+		message << _T(" of logger [") << logger->getName() << _T("].");
+	}
+
+	// the summary goes through the other filters, not this one
+	void * previous = reporting.GetData();
+	reporting.SetData(this);
+
+	try
+	{
+		if (callSite != 0 && slot != &overflow)
+		{
+			LoggingEvent summary(logger, *level, message.str(), *callSite);
+			owner->doAppend(summary);
+		}
+		else
+		{
+			LoggingEvent summary(logger, *level, message.str());
+			owner->doAppend(summary);
+		}
+	}
+	catch(...)
+	{
+		reporting.SetData(previous);
+		throw;
+	}
+
+	reporting.SetData(previous);
+}
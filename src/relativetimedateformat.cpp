@@ -0,0 +1,81 @@
+/***************************************************************************
+                          relativetimedateformat.cpp  -  class RelativeTimeDateFormat
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/helpers/relativetimedateformat.h>
+#include <log4cxx/helpers/clock.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+RelativeTimeDateFormat::RelativeTimeDateFormat()
+: DateFormat(_T(""), _T(""))
+{
+	Clock::getTime(startTime, startMicroseconds);
+}
+
+void RelativeTimeDateFormat::format(tostream& os, time_t time,
+	long microseconds)
+{
+	tstring s;
+	format(s, time, microseconds);
+	os.write(s.data(), s.size());
+}
+
+void RelativeTimeDateFormat::format(tstring& output, time_t time,
+	long microseconds)
+{
+	appendElapsed(output, startTime, startMicroseconds, time, microseconds);
+}
+
+void RelativeTimeDateFormat::appendElapsed(tstring& output,
+	time_t startTime, long startMicroseconds, time_t time, long microseconds)
+{
+	time_t seconds = time - startTime;
+	long millis = (microseconds - startMicroseconds) / 1000;
+	if (microseconds < startMicroseconds)
+	{
+		millis = (microseconds + 1000000 - startMicroseconds) / 1000;
+		seconds--;
+	}
+
+	if (seconds < 0)
+	{
+		output += _T('0');
+		return;
+	}
+
+	// the seconds followed by the milliseconds on 3 digits, so that
+	// the value does not overflow a long
+	TCHAR digits[32];
+	TCHAR * p = digits + 32;
+	int count = 0;
+
+	do
+	{
+		*--p = (TCHAR)(_T('0') + millis % 10);
+		millis /= 10;
+		count++;
+	}
+	while (count < 3 && (millis != 0 || seconds != 0));
+
+	while (seconds != 0)
+	{
+		*--p = (TCHAR)(_T('0') + seconds % 10);
+		seconds /= 10;
+	}
+
+	output.append(p, digits + 32 - p);
+}
@@ -0,0 +1,217 @@
+/***************************************************************************
+                          ringbuffer.cpp  -  RingBuffer
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+* Copyright (C) The Apache Software Foundation. All rights reserved.      *
+*                                                                         *
+* This software is published under the terms of the Apache Software       *
+* License version 1.1, a copy of which has been included with this        *
+* distribution in the LICENSE.txt file.                                   *
+***************************************************************************/
+
+#include <log4cxx/helpers/ringbuffer.h>
+#include <log4cxx/helpers/atomic.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/exception.h>
+
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace
+{
+	// difference between two positions, correct across wrap around
+	inline long distance(long a, long b)
+	{
+		return (long)((unsigned long)a - (unsigned long)b);
+	}
+}
+
+RingBuffer::RingBuffer(int capacity)
+: tail(0), head(0), consumerWaiting(0), producersWaiting(0)
+{
+	if(capacity < 1)
+	{
+		tostringstream oss;
+		oss << _T("The capacity argument (") << capacity
+			<< _T(") is not a positive integer.");
+		throw new IllegalArgumentException(oss.str());
+	}
+
+	this->capacity = 1;
+	while(this->capacity < capacity)
+	{
+		this->capacity <<= 1;
+	}
+	mask = this->capacity - 1;
+
+	events = new LoggingEvent[this->capacity];
+	sequences = new long[this->capacity];
+	for(int i = 0; i < this->capacity; i++)
+	{
+		sequences[i] = i;
+	}
+}
+
+RingBuffer::~RingBuffer()
+{
+	delete [] events;
+	delete [] (long *)sequences;
+}
+
+bool RingBuffer::offer(const LoggingEvent& event)
+{
+	long pos = Atomic::get(&tail);
+
+	while(true)
+	{
+		int index = (int)(pos & mask);
+		long dif = distance(Atomic::get(&sequences[index]), pos);
+
+		if(dif == 0)
+		{
+			if(Atomic::compareAndSet(&tail, pos, pos + 1))
+			{
+				events[index] = event;
+				Atomic::set(&sequences[index], pos + 1);
+				signalConsumer();
+				return true;
+			}
+			pos = Atomic::get(&tail);
+		}
+		else if(dif < 0)
+		{
+			// the slot still holds the event from the previous lap
+			return false;
+		}
+		else
+		{
+			// another producer claimed this position
+			pos = Atomic::get(&tail);
+		}
+	}
+}
+
+void RingBuffer::put(const LoggingEvent& event)
+{
+	if(offer(event))
+	{
+		return;
+	}
+
+	Atomic::increment(&producersWaiting);
+	while(!offer(event))
+	{
+		notFull.wait();
+	}
+	Atomic::decrement(&producersWaiting);
+}
+
+LoggingEvent * RingBuffer::get()
+{
+	long pos = Atomic::get(&head);
+
+	while(true)
+	{
+		int index = (int)(pos & mask);
+		long dif = distance(Atomic::get(&sequences[index]), pos + 1);
+
+		if(dif == 0)
+		{
+			if(Atomic::compareAndSet(&head, pos, pos + 1))
+			{
+				return &events[index];
+			}
+			pos = Atomic::get(&head);
+		}
+		else if(dif < 0)
+		{
+			return 0;
+		}
+		else
+		{
+			pos = Atomic::get(&head);
+		}
+	}
+}
+
+LoggingEvent * RingBuffer::evict()
+{
+	long pos = Atomic::get(&head);
+
+	// the slots of the events claimed by the consumer come before the
+	// oldest event, the next event goes to the first of them
+	if(distance(Atomic::get(&tail), pos) < capacity)
+	{
+		return 0;
+	}
+
+	int index = (int)(pos & mask);
+	if(distance(Atomic::get(&sequences[index]), pos + 1) != 0
+		|| !Atomic::compareAndSet(&head, pos, pos + 1))
+	{
+		return 0;
+	}
+
+	return &events[index];
+}
+
+void RingBuffer::release(const LoggingEvent * event)
+{
+	int index = (int)(event - events);
+
+	// the claimed slot holds sequence pos + 1, hand it over to the
+	// producer of the next lap.
+	long seq = Atomic::get(&sequences[index]);
+	Atomic::set(&sequences[index], seq - 1 + capacity);
+
+	Atomic::memoryBarrier();
+	if(Atomic::get(&producersWaiting) > 0)
+	{
+		notFull.post();
+	}
+}
+
+void RingBuffer::signalConsumer()
+{
+	Atomic::memoryBarrier();
+	if(Atomic::get(&consumerWaiting) != 0
+		&& Atomic::compareAndSet(&consumerWaiting, 1, 0))
+	{
+		notify();
+	}
+}
+
+void RingBuffer::await()
+{
+	Atomic::set(&consumerWaiting, 1);
+	Atomic::memoryBarrier();
+
+	if(isEmpty())
+	{
+		wait();
+	}
+
+	Atomic::set(&consumerWaiting, 0);
+}
+
+void RingBuffer::wakeUp()
+{
+	notify();
+}
+
+bool RingBuffer::isEmpty() const
+{
+	long pos = Atomic::get(&head);
+	return distance(Atomic::get(&sequences[pos & mask]), pos + 1) < 0;
+}
+
+int RingBuffer::length() const
+{
+	long size = distance(Atomic::get(&tail), Atomic::get(&head));
+	return (int)(size < 0 ? 0 : (size > capacity ? capacity : size));
+}
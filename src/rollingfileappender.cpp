@@ -44,12 +44,11 @@ maxFileSize(10*1024*1024), maxBackupIndex(1)
 // synchronization not necessary since doAppend is alreasy synched
 void RollingFileAppender::rollOver()
 {
-	LOGLOG_DEBUG(_T("rolling over count=") << ofs.tellp());
+	LOGLOG_DEBUG(_T("rolling over count=") << getFileLength());
 	LOGLOG_DEBUG(_T("maxBackupIndex=") << maxBackupIndex);
 
 	// close and reset the current file
-	ofs.close();
-	ofs.clear();
+	closeFile();
 
 	// If maxBackups <= 0, then there is no file renaming to be done.
 	if(maxBackupIndex > 0)
@@ -80,8 +79,7 @@ void RollingFileAppender::rollOver()
 	}
 
 	// Open the current file up again in truncation mode
-	ofs.open(T2A(fileName.c_str()), std::ios::out|std::ios::trunc);
-	if(!ofs.is_open())
+	if(!openFile(false))
 	{
 		LogLog::error(_T("Unable to open file: ") + fileName);
 	}
@@ -90,7 +88,26 @@ void RollingFileAppender::rollOver()
 void RollingFileAppender::subAppend(const spi::LoggingEvent& event)
 {
 	FileAppender::subAppend(event);
-	if(!fileName.empty() && ofs.tellp() >= maxFileSize)
+	if(!fileName.empty() && getFileLength() >= maxFileSize)
+	{
+		rollOver();
+	}
+}
+
+void RollingFileAppender::subAppend(const spi::LoggingEvent& event,
+	const tstring& formatted)
+{
+	FileAppender::subAppend(event, formatted);
+	if(!fileName.empty() && getFileLength() >= maxFileSize)
+	{
+		rollOver();
+	}
+}
+
+void RollingFileAppender::appendBatch(const spi::LoggingEventList& events)
+{
+	FileAppender::appendBatch(events);
+	if(!fileName.empty() && getFileLength() >= maxFileSize)
 	{
 		rollOver();
 	}
@@ -18,6 +18,7 @@
 #include <log4cxx/helpers/loglog.h>
 #include <log4cxx/level.h>
 #include <log4cxx/appender.h>
+#include <log4cxx/helpers/atomic.h>
 
 using namespace log4cxx;
 using namespace log4cxx::spi;
@@ -44,6 +45,7 @@ void RootCategory::setLevel(const Level& level)
 	{
 
 		this->level = &level;
+		Atomic::increment(generation);
 	}
 }
 
@@ -18,6 +18,8 @@
 
 #ifdef HAVE_PTHREAD_H
 #include <semaphore.h>
+#include <sys/time.h>
+#include <errno.h>
 #elif defined(WIN32)
 #include <windows.h>
 #include <limits.h>
@@ -87,6 +89,52 @@ bool Semaphore::tryWait()
 #endif
 }
 
+bool Semaphore::tryWait(long millis)
+{
+#ifdef HAVE_PTHREAD_H
+	struct timeval now;
+	::gettimeofday(&now, 0);
+
+	struct timespec deadline;
+	long nanos = now.tv_usec * 1000 + (millis % 1000) * 1000000;
+	deadline.tv_sec = now.tv_sec + millis / 1000 + nanos / 1000000000;
+	deadline.tv_nsec = nanos % 1000000000;
+
+	int result;
+	while ((result = ::sem_timedwait(&semaphore, &deadline)) != 0 &&
+		errno == EINTR)
+	{
+	}
+
+	if (result == 0)
+	{
+		return true;
+	}
+
+	if (errno != ETIMEDOUT)
+	{
+		throw SemaphoreException();
+	}
+
+	return false;
+#elif defined(WIN32)
+	bool bSuccess;
+	switch(::WaitForSingleObject(semaphore, (DWORD)millis))
+	{
+	case WAIT_OBJECT_0:
+		bSuccess = true;
+		break;
+	case WAIT_TIMEOUT:
+		bSuccess = false;
+		break;
+	default:
+		throw SemaphoreException();
+		break;
+	}
+	return bSuccess;
+#endif
+}
+
 void Semaphore::post()
 {
 #ifdef HAVE_PTHREAD_H
@@ -62,6 +62,8 @@ SocketAppender::~SocketAppender()
 
 void SocketAppender::activateOptions()
 {
+	AppenderSkeleton::activateOptions();
+
 	connect();
 }
 
@@ -92,6 +94,9 @@ void SocketAppender::setOption(const std::string& option,
 
 void SocketAppender::close()
 {
+	// the filters append what they hold back while the appender is open
+	closeFilters();
+
 	synchronized sync(this);
 
 	if(closed)
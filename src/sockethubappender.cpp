@@ -47,6 +47,8 @@ SocketHubAppender::SocketHubAppender(int port)
 
 void SocketHubAppender::activateOptions()
 {
+	AppenderSkeleton::activateOptions();
+
 	startServer();
 }
 
@@ -70,6 +72,9 @@ void SocketHubAppender::setOption(const std::string& option,
 
 void SocketHubAppender::close()
 {
+	// the filters append what they hold back while the appender is open
+	closeFilters();
+
 	synchronized sync(this);
 
 	if(closed)
@@ -17,6 +17,7 @@
 #include <log4cxx/helpers/socketoutputstream.h>
 #include <log4cxx/helpers/socket.h>
 #include <log4cxx/helpers/loglog.h>
+#include <string.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -88,15 +89,16 @@ void SocketOutputStream::write(const tstring& value)
 {
 	tstring::size_type size;
 
+	// the longer strings are truncated to what SocketInputStream reads
 	size = value.size();
+	if (size > 1024)
+	{
+		size = 1024;
+	}
+
 	write(&size, sizeof(tstring::size_type));
 	if (size > 0)
 	{
-		if (size > 1024)
-		{
-			size = 1024;
-		}
-		
 		write(value.c_str(), size * sizeof(TCHAR));
 	}
 }
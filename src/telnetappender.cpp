@@ -38,6 +38,8 @@ TelnetAppender::~TelnetAppender()
 
 void TelnetAppender::activateOptions() 
 {
+	AppenderSkeleton::activateOptions();
+
 	try 
 	{
 		sh = new SocketHandler(port);
@@ -64,6 +66,9 @@ void TelnetAppender::setOption(const std::string& option,
 
 void TelnetAppender::close() 
 {
+	// the filters append what they hold back while the appender is open
+	closeFilters();
+
 	if (sh)
 	{
 		sh->finalize();
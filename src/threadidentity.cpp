@@ -0,0 +1,91 @@
+/***************************************************************************
+                          threadidentity.cpp  -  class ThreadIdentity
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include <log4cxx/helpers/threadidentity.h>
+#include <log4cxx/helpers/atomic.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+namespace
+{
+	void releaseIdentity(void * data)
+	{
+		((ThreadIdentity *)data)->releaseRef();
+	}
+}
+
+volatile long ThreadIdentity::lastId = 0;
+ThreadSpecificData ThreadIdentity::threadSpecificData(releaseIdentity);
+
+ThreadIdentity::ThreadIdentity(unsigned long id, const tstring& name)
+: refCount(0), id(id), name(name)
+{
+	if (name.empty())
+	{
+		TCHAR digits[24];
+		TCHAR * p = digits + 24;
+		do
+		{
+			*--p = (TCHAR)(_T('0') + id % 10);
+			id /= 10;
+		}
+		while (id != 0);
+
+		text.assign(p, digits + 24 - p);
+	}
+	else
+	{
+		text = name;
+	}
+}
+
+void ThreadIdentity::addRef()
+{
+	Atomic::increment(&refCount);
+}
+
+void ThreadIdentity::releaseRef()
+{
+	if (Atomic::decrement(&refCount) <= 0)
+	{
+		delete this;
+	}
+}
+
+ThreadIdentity * ThreadIdentity::getCurrent()
+{
+	ThreadIdentity * identity =
+		(ThreadIdentity *)threadSpecificData.GetData();
+	if (identity == 0)
+	{
+		identity = new ThreadIdentity(Atomic::increment(&lastId), tstring());
+		identity->addRef();
+		threadSpecificData.SetData(identity);
+	}
+
+	return identity;
+}
+
+void ThreadIdentity::setCurrentName(const tstring& name)
+{
+	// the events logged before keep the previous identity
+	ThreadIdentity * previous = getCurrent();
+	ThreadIdentity * identity = new ThreadIdentity(previous->id, name);
+	identity->addRef();
+	threadSpecificData.SetData(identity);
+	previous->releaseRef();
+}
@@ -30,7 +30,22 @@ using namespace log4cxx::helpers;
 ThreadSpecificData::ThreadSpecificData() : key(0)
 {
 #ifdef HAVE_PTHREAD_H
-	pthread_key_create((pthread_key_t *)&key, NULL);
+	// the key is kept in a pointer, which may be wider than it
+	pthread_key_t pthreadKey;
+	pthread_key_create(&pthreadKey, NULL);
+	key = (void *)(size_t)pthreadKey;
+#elif defined(WIN32)
+	key = (void *)TlsAlloc();
+#endif
+}
+
+ThreadSpecificData::ThreadSpecificData(void (*cleanup)(void * data)) : key(0)
+{
+#ifdef HAVE_PTHREAD_H
+	// the key is kept in a pointer, which may be wider than it
+	pthread_key_t pthreadKey;
+	pthread_key_create(&pthreadKey, cleanup);
+	key = (void *)(size_t)pthreadKey;
 #elif defined(WIN32)
 	key = (void *)TlsAlloc();
 #endif
@@ -39,7 +54,7 @@ ThreadSpecificData::ThreadSpecificData() : key(0)
 ThreadSpecificData::~ThreadSpecificData()
 {
 #ifdef HAVE_PTHREAD_H
-	pthread_key_delete((pthread_key_t)key);
+	pthread_key_delete((pthread_key_t)(size_t)key);
 #elif defined(WIN32)
 	TlsFree((DWORD)key);
 #endif
@@ -48,7 +63,7 @@ ThreadSpecificData::~ThreadSpecificData()
 void * ThreadSpecificData::GetData() const
 {
 #ifdef HAVE_PTHREAD_H
-	return pthread_getspecific((pthread_key_t)key);
+	return pthread_getspecific((pthread_key_t)(size_t)key);
 #elif defined(WIN32)
 	return TlsGetValue((DWORD)key);
 #else
@@ -59,7 +74,7 @@ void * ThreadSpecificData::GetData() const
 void ThreadSpecificData::SetData(void * data)
 {
 #ifdef HAVE_PTHREAD_H
-	pthread_setspecific((pthread_key_t)key, data);
+	pthread_setspecific((pthread_key_t)(size_t)key, data);
 #elif defined(WIN32)
 	TlsSetValue((DWORD)key, data);
 #else
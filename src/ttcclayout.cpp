@@ -43,7 +43,7 @@ void TTCCLayout::format(tostream& output, const spi::LoggingEvent& event)
 
 	if(threadPrinting)
 	{
-		output << _T("[") << event.getThreadId() << _T("] ");
+		output << _T("[") << event.getThreadName() << _T("] ");
 	}
 	
 	output << event.getLevel().toString() << _T(" ");
@@ -59,6 +59,62 @@ void WriterAppender::append(const spi::LoggingEvent& event)
 	subAppend(event);
 }
 
+void WriterAppender::appendBatch(const spi::LoggingEventList& events)
+{
+	if(!checkEntryConditions())
+	{
+		return;
+	}
+
+	// subAppend must not flush after each event of the batch
+	bool flush = immediateFlush;
+	immediateFlush = false;
+
+	LoggingEventList::const_iterator it, itEnd = events.end();
+	for(it = events.begin(); it != itEnd; it++)
+	{
+		subAppend(**it);
+	}
+
+	immediateFlush = flush;
+
+	if(immediateFlush && os != 0)
+	{
+		os->flush();
+	}
+}
+
+bool WriterAppender::prepare(const spi::LoggingEvent& event,
+	tstring& output)
+{
+	// a reference is held while formatting without the lock, in
+	// case the layout is replaced meanwhile
+	LayoutPtr layout;
+	{
+		synchronized sync(this);
+		layout = this->layout;
+	}
+
+	if(layout == 0)
+	{
+		return false;
+	}
+
+	layout->format(output, event);
+	return true;
+}
+
+void WriterAppender::commit(const spi::LoggingEvent& event,
+	const tstring& formatted)
+{
+	if(!checkEntryConditions())
+	{
+		return;
+	}
+
+	subAppend(event, formatted);
+}
+
 bool WriterAppender::checkEntryConditions()
 {
 	if(closed)
@@ -88,6 +144,9 @@ bool WriterAppender::checkEntryConditions()
 
 void WriterAppender::close()
 {
+	// the filters append what they hold back while the appender is open
+	closeFilters();
+
 	synchronized sync(this);
 	
 	if(closed)
@@ -110,6 +169,17 @@ void WriterAppender::subAppend(const spi::LoggingEvent& event)
 	}
 }
 
+void WriterAppender::subAppend(const spi::LoggingEvent& /* event */,
+	const tstring& formatted)
+{
+	os->write(formatted.data(), formatted.size());
+
+	if(immediateFlush)
+	{
+		os->flush();
+	}
+}
+
 void WriterAppender::reset()
 {
 	closeWriter();
@@ -50,11 +50,12 @@ void XMLLayout::format(tostream& output, const spi::LoggingEvent& event)
 //	output << _T("<event logger=\"");
 	output << event.getLoggerName();
 	output << _T("\" timestamp=\"");
-	ISO8601DateFormat().format(output, event.getTimeStamp());
+	dateFormat.format(output, event.getTimeStamp(),
+		event.getMicroseconds());
 	output << _T("\" level=\"");
 	output << event.getLevel().toString();
 	output << _T("\" thread=\"");
-	output << event.getThreadId();
+	output << event.getThreadName();
 	output << _T("\">\r\n");
 
 	output << _T("<log4cxx:message><![CDATA[");
@@ -79,8 +80,10 @@ void XMLLayout::format(tostream& output, const spi::LoggingEvent& event)
 	{
 		output << _T("<log4cxx:locationInfo file=\"");
 //		output << _T("<locationInfo file=\"");
-		USES_CONVERSION;
-		output << A2T(event.getFile());
+		if (event.getFileName() != 0)
+		{
+			output << event.getFileName();
+		}
 		output << _T("\" line=\"");
 		output << event.getLine();
 		output << _T("\"/>\r\n");
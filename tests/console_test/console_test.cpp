@@ -0,0 +1,78 @@
+/***************************************************************************
+                          console_test.cpp  -  console_test main
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include <string.h>
+
+namespace
+{
+	struct Test
+	{
+		const char * name;
+		int (*run)();
+	};
+
+	Test tests[] =
+	{
+		{ "disabledstatement", disabledStatementBenchmark },
+		{ "ringbuffer", ringBufferTest },
+		{ "asyncappender", asyncAppenderTest },
+		{ "filter", filterTest },
+		{ "ratelimitfilter", rateLimitFilterTest },
+		{ "duplicatemessagefilter", duplicateMessageFilterTest },
+		{ "ndc", ndcTest },
+		{ "mdc", mdcTest },
+		{ "fileappender", fileAppenderTest },
+		{ "mappedfileappender", mappedFileAppenderTest },
+		{ "hierarchy", hierarchyTest },
+		{ "loggingevent", loggingEventTest },
+		{ "patternlayout", patternLayoutTest },
+		{ "threadidentity", threadIdentityTest },
+		{ "writerappender", writerAppenderTest }
+	};
+}
+
+/**
+Runs the tests named on the command line, or all of them, and returns
+the number of failures.
+*/
+int main(int argc, char **argv)
+{
+	int failures = 0;
+	int testCount = sizeof(tests) / sizeof(tests[0]);
+
+	for (int i = 0; i < testCount; i++)
+	{
+		bool selected = (argc < 2);
+		for (int arg = 1; arg < argc && !selected; arg++)
+		{
+			selected = (strcmp(argv[arg], tests[i].name) == 0);
+		}
+
+		if (selected)
+		{
+			std::cout << tests[i].name << std::endl;
+			failures += tests[i].run();
+		}
+	}
+
+	if (failures > 0)
+	{
+		std::cerr << failures << " failure(s)" << std::endl;
+	}
+
+	return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+/***************************************************************************
+                  disabledbenchmark.cpp  -  disabled statement benchmark
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/helpers/clock.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+namespace
+{
+	int evaluations = 0;
+
+	/** Counts the messages built, none for a disabled statement. */
+	int evaluate(int i)
+	{
+		evaluations++;
+		return i;
+	}
+
+	double microseconds()
+	{
+		time_t seconds;
+		long micros;
+		Clock::getTime(seconds, micros);
+		return (double)seconds * 1000000.0 + (double)micros;
+	}
+}
+
+int disabledStatementBenchmark()
+{
+	int failures = 0;
+	const int count = 10000000;
+
+	// the level is inherited, as most loggers do
+	LoggerPtr parent = Logger::getLogger(_T("benchmark"));
+	LoggerPtr logger = Logger::getLogger(_T("benchmark.disabled"));
+	parent->setLevel(Level::INFO);
+
+	double start = microseconds();
+	for (int i = 0; i < count; i++)
+	{
+		LOG4CXX_DEBUG(logger, _T("disabled ") << evaluate(i));
+	}
+	double elapsed = microseconds() - start;
+
+	CHECK(evaluations == 0);
+	std::cout << "  " << (elapsed * 1000.0 / count)
+		<< " ns per disabled LOG4CXX_DEBUG statement" << std::endl;
+
+	// the level of the parent changes the cached effective level
+	parent->setLevel(Level::DEBUG);
+	CHECK(logger->isDebugEnabled());
+	parent->setLevel(Level::WARN);
+	CHECK(!logger->isInfoEnabled());
+	CHECK(logger->isWarnEnabled());
+
+	return failures;
+}
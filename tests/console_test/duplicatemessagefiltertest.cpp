@@ -0,0 +1,165 @@
+/***************************************************************************
+      duplicatemessagefiltertest.cpp  -  DuplicateMessageFilter tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include "vectorappender.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/varia/duplicatemessagefilter.h>
+#include <log4cxx/helpers/thread.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+using namespace log4cxx::varia;
+
+namespace
+{
+	/** Returns a logger appending to <code>filtered</code>, which
+	collapses the series of identical events, and to
+	<code>other</code>. */
+	LoggerPtr dedupLogger(const tstring& name, VectorAppender * filtered,
+		VectorAppender * other, bool keyByLocation)
+	{
+		DuplicateMessageFilter * filter = new DuplicateMessageFilter();
+		FilterPtr filterPtr = filter;
+		filter->setWindow(200);
+		filter->setKeyByLocation(keyByLocation);
+		filtered->addFilter(filterPtr);
+
+		LoggerPtr logger = Logger::getLogger(name);
+		logger->setAdditivity(false);
+		logger->removeAllAppenders();
+		logger->addAppender(filtered);
+		logger->addAppender(other);
+		return logger;
+	}
+
+	int messageTest()
+	{
+		int failures = 0;
+
+		VectorAppender * filtered = new VectorAppender();
+		AppenderPtr filteredPtr = filtered;
+		VectorAppender * other = new VectorAppender();
+		AppenderPtr otherPtr = other;
+		LoggerPtr logger = dedupLogger(_T("dedup"), filtered, other, false);
+
+		for (int i = 0; i < 5; i++)
+		{
+			logger->info(_T("same"));
+		}
+
+		// the same message at another level is another series
+		logger->warn(_T("same"));
+
+		// the first event after the window ends the series, the
+		// summaries come before it
+		Thread::sleep(300);
+		logger->warn(_T("other"));
+		for (int i = 0; i < 3; i++)
+		{
+			logger->warn(_T("again"));
+		}
+
+		// the last series is reported when the appender is closed
+		logger->removeAllAppenders();
+
+		std::vector<tstring> expected;
+		expected.push_back(_T("same"));
+		expected.push_back(_T("same"));
+		expected.push_back(_T("Last message repeated 4 times: same"));
+		expected.push_back(_T("other"));
+		expected.push_back(_T("again"));
+		expected.push_back(_T("Last message repeated 2 times: again"));
+		CHECK(filtered->messages == expected);
+
+		std::vector<int> levels;
+		levels.push_back(Level::INFO_INT);
+		levels.push_back(Level::WARN_INT);
+		levels.push_back(Level::INFO_INT);
+		levels.push_back(Level::WARN_INT);
+		levels.push_back(Level::WARN_INT);
+		levels.push_back(Level::WARN_INT);
+		CHECK(filtered->levels == levels);
+
+		CHECK(other->messages.size() == 10);
+		CHECK(other->count(_T("Last message")) == 0);
+
+		// a message logged again after the window starts a new series
+		filtered = new VectorAppender();
+		filteredPtr = filtered;
+		other = new VectorAppender();
+		otherPtr = other;
+		logger = dedupLogger(_T("dedup"), filtered, other, false);
+
+		for (int i = 0; i < 2; i++)
+		{
+			logger->info(_T("tick"));
+		}
+
+		Thread::sleep(300);
+		logger->info(_T("tick"));
+		logger->removeAllAppenders();
+
+		expected.clear();
+		expected.push_back(_T("tick"));
+		expected.push_back(_T("Last message repeated 1 time: tick"));
+		expected.push_back(_T("tick"));
+		CHECK(filtered->messages == expected);
+
+		return failures;
+	}
+
+	int locationTest()
+	{
+		int failures = 0;
+
+		// the events of a statement are identical whatever their
+		// message
+		VectorAppender * filtered = new VectorAppender();
+		AppenderPtr filteredPtr = filtered;
+		VectorAppender * other = new VectorAppender();
+		AppenderPtr otherPtr = other;
+		LoggerPtr logger = dedupLogger(_T("dedup.location"), filtered,
+			other, true);
+
+		for (int i = 0; i < 5; i++)
+		{
+			LOG4CXX_INFO(logger, _T("n ") << i);
+		}
+
+		logger->removeAllAppenders();
+
+		std::vector<tstring> expected;
+		expected.push_back(_T("n 0"));
+		expected.push_back(_T("Last message repeated 4 times: n 0"));
+		CHECK(filtered->messages == expected);
+		CHECK(other->messages.size() == 5);
+
+		return failures;
+	}
+}
+
+int duplicateMessageFilterTest()
+{
+	int failures = 0;
+
+	failures += messageTest();
+	failures += locationTest();
+
+	return failures;
+}
@@ -0,0 +1,225 @@
+/***************************************************************************
+               fileappendertest.cpp  -  FileAppender tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/fileappender.h>
+#include <log4cxx/simplelayout.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/thread.h>
+#include <fstream>
+#include <iterator>
+#include <stdio.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace
+{
+	/** Returns the content of the file <code>fileName</code>. */
+	tstring readFile(const tstring& fileName)
+	{
+		std::basic_ifstream<TCHAR> file(T2A(fileName.c_str()));
+		return tstring(std::istreambuf_iterator<TCHAR>(file),
+			std::istreambuf_iterator<TCHAR>());
+	}
+
+	/** Returns the lines SimpleLayout writes for the INFO events
+	<code>prefix</code> from <code>first</code> to <code>last</code>. */
+	tstring lines(const tstring& prefix, int first, int last)
+	{
+		tostringstream oss;
+		for (int i = first; i <= last; i++)
+		{
+			oss << _T("INFO - ") << prefix << i << std::endl;
+		}
+
+		return oss.str();
+	}
+
+	void log(const LoggerPtr& logger, const tstring& prefix,
+		int first, int last)
+	{
+		for (int i = first; i <= last; i++)
+		{
+			LOG4CXX_INFO(logger, prefix << i);
+		}
+	}
+
+	LoggerPtr fileLogger(const tstring& name, const AppenderPtr& appender)
+	{
+		LoggerPtr logger = Logger::getLogger(name);
+		logger->setAdditivity(false);
+		logger->setLevel(Level::DEBUG);
+		logger->removeAllAppenders();
+		logger->addAppender(appender);
+		return logger;
+	}
+
+	int bufferedTest()
+	{
+		int failures = 0;
+		const tstring fileName = _T("console_test_buffered.log");
+		const tstring otherName = _T("console_test_buffered2.log");
+
+		FileAppender * appender = new FileAppender();
+		AppenderPtr appenderPtr = appender;
+		appender->setLayout(new SimpleLayout());
+		appender->setFile(fileName);
+		appender->setAppend(false);
+		appender->setBufferedIO(true);
+		appender->setBufferSize(64);
+		appender->setFlushInterval(0);
+		appender->activateOptions();
+		LoggerPtr logger = fileLogger(_T("fileappender.buffered"), appender);
+
+		// the events stay in the buffer until a WARN event
+		log(logger, _T("b"), 0, 1);
+		CHECK(readFile(fileName).empty());
+
+		logger->warn(_T("w"));
+		tstring expected = lines(_T("b"), 0, 1) + _T("WARN - w\n");
+		CHECK(readFile(fileName) == expected);
+
+		// or until the buffer is full
+		log(logger, _T("b"), 2, 21);
+		expected += lines(_T("b"), 2, 21);
+		tstring content = readFile(fileName);
+		CHECK(content.size() >= expected.size() - 64);
+		CHECK(content == expected.substr(0, content.size()));
+
+		// the buffer goes to the file before it is opened again
+		appender->setFile(otherName);
+		appender->activateOptions();
+		CHECK(readFile(fileName) == expected);
+
+		// the flusher writes the buffer after the interval
+		appender->setFile(fileName);
+		appender->setAppend(true);
+		appender->setFlushInterval(100);
+		appender->activateOptions();
+		log(logger, _T("t"), 0, 0);
+		expected += lines(_T("t"), 0, 0);
+		Thread::sleep(500);
+		CHECK(readFile(fileName) == expected);
+
+		log(logger, _T("c"), 0, 2);
+		logger->removeAllAppenders();
+		expected += lines(_T("c"), 0, 2);
+		CHECK(readFile(fileName) == expected);
+		CHECK(readFile(otherName).empty());
+
+		::remove(T2A(fileName.c_str()));
+		::remove(T2A(otherName.c_str()));
+
+		return failures;
+	}
+
+	int rawTest()
+	{
+		int failures = 0;
+		const tstring fileName = _T("console_test_raw.log");
+
+		FileAppender * appender = new FileAppender();
+		AppenderPtr appenderPtr = appender;
+		appender->setLayout(new SimpleLayout());
+		appender->setFile(fileName);
+		appender->setAppend(false);
+		appender->setRawIO(true);
+		appender->activateOptions();
+		LoggerPtr logger = fileLogger(_T("fileappender.raw"), appender);
+
+		// each event is written as it is appended
+		log(logger, _T("r"), 0, 2);
+		tstring expected = lines(_T("r"), 0, 2);
+		CHECK(readFile(fileName) == expected);
+
+		// a batch larger than the vector of one system call
+		std::vector<LoggingEvent *> events;
+		LoggingEventList batch;
+		for (int i = 0; i < 100; i++)
+		{
+			tostringstream message;
+			message << _T("v") << i;
+			events.push_back(new LoggingEvent(logger, Level::INFO,
+				message.str()));
+			batch.push_back(events.back());
+		}
+
+		appender->doAppendBatch(batch);
+		expected += lines(_T("v"), 0, 99);
+		CHECK(readFile(fileName) == expected);
+
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			delete events[i];
+		}
+
+		// another appender on the same file writes after the end of
+		// the file, not over the events of the first one
+		FileAppender * second = new FileAppender();
+		AppenderPtr secondPtr = second;
+		second->setLayout(new SimpleLayout());
+		second->setFile(fileName);
+		second->setRawIO(true);
+		second->setSyncPolicy(FileAppender::SYNC_BATCH);
+		second->activateOptions();
+		LoggerPtr secondLogger = fileLogger(_T("fileappender.raw2"),
+			second);
+
+		log(secondLogger, _T("s"), 0, 0);
+		log(logger, _T("r"), 3, 3);
+		log(secondLogger, _T("s"), 1, 1);
+		secondLogger->removeAllAppenders();
+		expected += lines(_T("s"), 0, 0) + lines(_T("r"), 3, 3)
+			+ lines(_T("s"), 1, 1);
+		CHECK(readFile(fileName) == expected);
+
+		// with a buffer, the events wait for a WARN event
+		appender->setAppend(true);
+		appender->setBufferedIO(true);
+		appender->setBufferSize(256);
+		appender->setFlushInterval(0);
+		appender->activateOptions();
+
+		log(logger, _T("p"), 0, 1);
+		CHECK(readFile(fileName) == expected);
+		logger->error(_T("e"));
+		expected += lines(_T("p"), 0, 1) + _T("ERROR - e\n");
+		CHECK(readFile(fileName) == expected);
+
+		log(logger, _T("p"), 2, 2);
+		logger->removeAllAppenders();
+		expected += lines(_T("p"), 2, 2);
+		CHECK(readFile(fileName) == expected);
+
+		::remove(T2A(fileName.c_str()));
+
+		return failures;
+	}
+}
+
+int fileAppenderTest()
+{
+	int failures = 0;
+
+	failures += bufferedTest();
+	failures += rawTest();
+
+	return failures;
+}
@@ -0,0 +1,343 @@
+/***************************************************************************
+                 filtertest.cpp  -  compiled filter verdict tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include "vectorappender.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/varia/denyallfilter.h>
+#include <log4cxx/varia/levelmatchfilter.h>
+#include <log4cxx/varia/levelrangefilter.h>
+#include <log4cxx/varia/stringmatchfilter.h>
+#include <log4cxx/varia/multistringmatchfilter.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/spi/loggingevent.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+using namespace log4cxx::varia;
+
+namespace
+{
+	/** Logs <code>text</code> at each level to <code>appender</code>,
+	returns the initials of the levels it appended, "DIWEF" for all. */
+	tstring verdicts(VectorAppender * appender, const tstring& text)
+	{
+		LoggerPtr logger = Logger::getLogger(_T("filter"));
+		logger->setAdditivity(false);
+		logger->setLevel(Level::DEBUG);
+		logger->removeAllAppenders();
+		logger->addAppender(appender);
+
+		appender->messages.clear();
+		appender->levels.clear();
+
+		logger->debug(_T("D ") + text);
+		logger->info(_T("I ") + text);
+		logger->warn(_T("W ") + text);
+		logger->error(_T("E ") + text);
+		logger->fatal(_T("F ") + text);
+
+		// removing all the appenders would close it
+		logger->removeAppender(appender);
+
+		tstring initials;
+		for (size_t i = 0; i < appender->messages.size(); i++)
+		{
+			initials += appender->messages[i][0];
+		}
+
+		return initials;
+	}
+
+	tstring verdicts(VectorAppender * appender)
+	{
+		return verdicts(appender, _T("message"));
+	}
+
+	/** Recompiles the filters of an appender while it is used. */
+	class Reactivator : public Thread
+	{
+	public:
+		Reactivator(VectorAppender * appender, int count, Semaphore& done)
+		: appender(appender), count(count), done(done)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < count; i++)
+			{
+				appender->activateOptions();
+			}
+
+			done.post();
+		}
+
+	protected:
+		AppenderPtr appender;
+		int count;
+		Semaphore& done;
+	};
+
+	int levelFilterTest()
+	{
+		int failures = 0;
+
+		VectorAppender * appender = new VectorAppender();
+		AppenderPtr appenderPtr = appender;
+		CHECK(verdicts(appender) == _T("DIWEF"));
+
+		// the levels outside of the range are denied
+		LevelRangeFilter * range = new LevelRangeFilter();
+		FilterPtr rangePtr = range;
+		range->setLevelMin(Level::INFO);
+		range->setLevelMax(Level::ERROR);
+		range->setAcceptOnMatch(false);
+		appender->addFilter(rangePtr);
+		CHECK(verdicts(appender) == _T("IWE"));
+
+		// the threshold is checked before the filters
+		appender->setThreshold(Level::WARN);
+		CHECK(verdicts(appender) == _T("WE"));
+		appender->setThreshold(Level::ALL);
+
+		// the first filter deciding wins
+		appender->clearFilters();
+		CHECK(verdicts(appender) == _T("DIWEF"));
+
+		LevelMatchFilter * match = new LevelMatchFilter();
+		FilterPtr matchPtr = match;
+		match->setLevelToMatch(_T("WARN"));
+		match->setAcceptOnMatch(true);
+		appender->addFilter(matchPtr);
+		appender->addFilter(new DenyAllFilter());
+		CHECK(verdicts(appender) == _T("W"));
+
+		// the options set after addFilter are compiled on activation,
+		// the way a configurator sets them
+		appender->clearFilters();
+		match = new LevelMatchFilter();
+		matchPtr = match;
+		appender->addFilter(matchPtr);
+		CHECK(verdicts(appender) == _T("DIWEF"));
+
+		match->setOption(_T("LevelToMatch"), _T("DEBUG"));
+		match->setOption(_T("AcceptOnMatch"), _T("false"));
+		appender->activateOptions();
+		CHECK(verdicts(appender) == _T("IWEF"));
+
+		match->setLevelToMatch(_T("ERROR"));
+		appender->activateOptions();
+		CHECK(verdicts(appender) == _T("DIWF"));
+
+		appender->close();
+		return failures;
+	}
+
+	int stringFilterTest()
+	{
+		int failures = 0;
+
+		// a filter on the message is decided for each event, the level
+		// filters after it still apply
+		VectorAppender * appender = new VectorAppender();
+		AppenderPtr appenderPtr = appender;
+
+		StringMatchFilter * string = new StringMatchFilter();
+		FilterPtr stringPtr = string;
+		string->setStringToMatch(_T("secret"));
+		string->setAcceptOnMatch(false);
+		appender->addFilter(stringPtr);
+
+		LevelRangeFilter * range = new LevelRangeFilter();
+		FilterPtr rangePtr = range;
+		range->setLevelMin(Level::WARN);
+		range->setLevelMax(Level::FATAL);
+		range->setAcceptOnMatch(true);
+		appender->addFilter(rangePtr);
+
+		CHECK(verdicts(appender, _T("plain")) == _T("WEF"));
+		CHECK(verdicts(appender, _T("a secret")) == _T(""));
+		appender->close();
+
+		// the first string matching decides
+		appender = new VectorAppender();
+		appenderPtr = appender;
+
+		MultiStringMatchFilter * strings = new MultiStringMatchFilter();
+		FilterPtr stringsPtr = strings;
+		strings->addString(_T("beta"), false);
+		strings->addString(_T("alpha"), true);
+		appender->addFilter(stringsPtr);
+		appender->addFilter(new DenyAllFilter());
+
+		CHECK(verdicts(appender, _T("alpha")) == _T("DIWEF"));
+		CHECK(verdicts(appender, _T("beta")) == _T(""));
+		CHECK(verdicts(appender, _T("alphabet")) == _T("DIWEF"));
+		CHECK(verdicts(appender, _T("gamma")) == _T(""));
+
+		strings->clear();
+		strings->addString(_T("gamma"), true);
+		appender->activateOptions();
+		CHECK(verdicts(appender, _T("alpha")) == _T(""));
+		CHECK(verdicts(appender, _T("gamma")) == _T("DIWEF"));
+
+		appender->close();
+		return failures;
+	}
+
+	/** Returns the decision of a chain of StringMatchFilter, the
+	first one which is not neutral. */
+	int chainDecision(const std::vector<FilterPtr>& chain,
+		const LoggingEvent& event)
+	{
+		for (size_t i = 0; i < chain.size(); i++)
+		{
+			int decision = chain[i]->decide(event);
+			if (decision != Filter::NEUTRAL)
+			{
+				return decision;
+			}
+		}
+
+		return Filter::NEUTRAL;
+	}
+
+	/** Counts the messages MultiStringMatchFilter decides otherwise
+	than the equivalent chain of StringMatchFilter. The strings starting
+	with '+' are accepted, the others denied. */
+	int compareToChain(const tstring * strings, int stringCount,
+		const tstring * messages, int messageCount)
+	{
+		int failures = 0;
+
+		MultiStringMatchFilter * multi = new MultiStringMatchFilter();
+		FilterPtr multiPtr = multi;
+		std::vector<FilterPtr> chain;
+
+		for (int i = 0; i < stringCount; i++)
+		{
+			bool accept = (strings[i][0] == _T('+'));
+			tstring text = strings[i].substr(1);
+			multi->addString(text, accept);
+
+			StringMatchFilter * string = new StringMatchFilter();
+			chain.push_back(string);
+			string->setStringToMatch(text);
+			string->setAcceptOnMatch(accept);
+		}
+
+		LoggerPtr logger = Logger::getLogger(_T("filter"));
+		for (int j = 0; j < messageCount; j++)
+		{
+			LoggingEvent event(logger, Level::INFO, messages[j]);
+			CHECK(multi->decide(event) == chainDecision(chain, event));
+		}
+
+		return failures;
+	}
+
+	int multiStringTest()
+	{
+		int failures = 0;
+
+		tstring messages[] =
+		{
+			_T(""), _T("h"), _T("she"), _T("ushers"), _T("ahishers"),
+			_T("hehe"), _T("xabcdx"), _T("abc"), _T("bcd"),
+			_T("un caf\xe9 \xe9t\xe9"), _T("\xe9t\xe9"), _T("\xff\xfe\xff"),
+			_T("p7q p42q"), _T("p99"), _T("p99q"), _T("pp1qq")
+		};
+		int messageCount = sizeof(messages) / sizeof(messages[0]);
+
+		// overlapping strings and suffixes, found through the failure
+		// links
+		tstring overlaps[] =
+			{ _T("-she"), _T("+he"), _T("+hers"), _T("-his") };
+		failures += compareToChain(overlaps, 4, messages, messageCount);
+
+		// the first string added decides, even if a later one ends
+		// earlier in the message
+		tstring precedence[] =
+			{ _T("+hers"), _T("-she"), _T("-he"), _T("+abcd"), _T("-bc") };
+		failures += compareToChain(precedence, 5, messages, messageCount);
+
+		// the characters out of ASCII
+		tstring bytes[] =
+			{ _T("-\xe9t\xe9"), _T("+caf\xe9"), _T("+\xfe\xff"), _T("-\xff") };
+		failures += compareToChain(bytes, 4, messages, messageCount);
+
+		// more states than rows of transitions
+		std::vector<tstring> many;
+		for (int i = 0; i < 100; i++)
+		{
+			tostringstream text;
+			text << ((i % 3 == 0) ? _T("+p") : _T("-p")) << i << _T("q");
+			many.push_back(text.str());
+		}
+		failures += compareToChain(&many[0], (int)many.size(),
+			messages, messageCount);
+
+		// no string
+		failures += compareToChain(0, 0, messages, messageCount);
+
+		return failures;
+	}
+
+	int concurrentTest()
+	{
+		int failures = 0;
+
+		// the events never see a table without the DenyAllFilter while
+		// it is compiled again
+		VectorAppender * appender = new VectorAppender();
+		AppenderPtr appenderPtr = appender;
+		appender->addFilter(new DenyAllFilter());
+		appender->activateOptions();
+
+		Semaphore done;
+		Thread * reactivator = new Reactivator(appender, 2000, done);
+		reactivator->start();
+
+		for (int i = 0; i < 2000; i++)
+		{
+			CHECK(verdicts(appender) == _T(""));
+		}
+
+		done.wait();
+
+		// the tables replaced meanwhile are deleted once unused
+		appender->activateOptions();
+		CHECK(appender->retiredFilterCount() == 0);
+
+		appender->close();
+		return failures;
+	}
+}
+
+int filterTest()
+{
+	int failures = 0;
+
+	failures += levelFilterTest();
+	failures += stringFilterTest();
+	failures += multiStringTest();
+	failures += concurrentTest();
+
+	return failures;
+}
@@ -0,0 +1,372 @@
+/***************************************************************************
+                hierarchytest.cpp  -  Hierarchy and logger level tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include "vectorappender.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/level.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/helpers/atomic.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace
+{
+	/** Creates a logger when it is closed, the way an appender
+	logging its own errors does. */
+	class LoggingAppender : public VectorAppender
+	{
+	public:
+		void close()
+		{
+			Logger::getLogger(_T("hierarchy.closing"));
+			VectorAppender::close();
+		}
+	};
+
+	/** Creates loggers while the test looks up others, then posts
+	<code>done</code>. */
+	class Creator : public Thread
+	{
+	public:
+		Creator(const tstring& prefix, int count, volatile long& mismatches,
+			Semaphore& done)
+		: prefix(prefix), count(count), mismatches(mismatches), done(done)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < count; i++)
+			{
+				tostringstream name;
+				name << prefix << i;
+
+				LoggerPtr created = Logger::getLogger(name.str());
+				if (created != Logger::getLogger(name.str())
+					|| created->getName() != name.str())
+				{
+					Atomic::increment(&mismatches);
+				}
+			}
+
+			done.post();
+		}
+
+	protected:
+		tstring prefix;
+		int count;
+		volatile long& mismatches;
+		Semaphore& done;
+	};
+
+	/** Attaches and detaches an appender while the test logs, then
+	posts <code>done</code>. */
+	class Toggler : public Thread
+	{
+	public:
+		Toggler(const LoggerPtr& logger, const AppenderPtr& appender,
+			int count, Semaphore& done)
+		: logger(logger), appender(appender), count(count), done(done)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < count; i++)
+			{
+				logger->addAppender(appender);
+				logger->removeAppender(appender);
+			}
+
+			done.post();
+		}
+
+	protected:
+		LoggerPtr logger;
+		AppenderPtr appender;
+		int count;
+		Semaphore& done;
+	};
+
+	int resetTest()
+	{
+		int failures = 0;
+
+		LoggerPtr logger = Logger::getLogger(_T("hierarchy.reset"));
+		logger->setLevel(Level::INFO);
+		logger->setAdditivity(false);
+
+		VectorAppender * appender = new LoggingAppender();
+		AppenderPtr appenderPtr = appender;
+		logger->addAppender(appender);
+
+		// the appenders are closed once the hierarchy is unlocked
+		LogManager::resetConfiguration();
+		CHECK(LogManager::exists(_T("hierarchy.closing")) != 0);
+
+		CHECK(logger->getLevel().equals(Level::OFF));
+		CHECK(logger->getAdditivity());
+		CHECK(logger->getAllAppenders().empty());
+		CHECK(LogManager::getRootLogger()->getLevel().equals(Level::DEBUG));
+
+		return failures;
+	}
+
+	int levelTest()
+	{
+		int failures = 0;
+		LoggerRepositoryPtr repository = LogManager::getLoggerRepository();
+
+		LoggerPtr parent = Logger::getLogger(_T("level"));
+		LoggerPtr child = Logger::getLogger(_T("level.a.b"));
+
+		// the child inherits the level of its parent
+		parent->setLevel(Level::WARN);
+		CHECK(!child->isInfoEnabled());
+		CHECK(child->isWarnEnabled());
+
+		// the cached level follows the changes of the ancestors
+		parent->setLevel(Level::DEBUG);
+		CHECK(child->isDebugEnabled());
+
+		child->setLevel(Level::ERROR);
+		CHECK(!child->isWarnEnabled());
+		CHECK(child->isErrorEnabled());
+		CHECK(parent->isDebugEnabled());
+
+		// a logger created between them becomes the parent of the child
+		LoggerPtr middle = Logger::getLogger(_T("level.a"));
+		middle->setLevel(Level::INFO);
+		child->setLevel(Level::OFF);
+		CHECK(!child->isDebugEnabled());
+		CHECK(child->isInfoEnabled());
+
+		// the threshold of the repository applies to all the loggers
+		repository->setThreshold(Level::ERROR);
+		CHECK(!child->isWarnEnabled());
+		CHECK(!parent->isInfoEnabled());
+		CHECK(parent->isErrorEnabled());
+
+		repository->setThreshold(Level::ALL);
+		CHECK(child->isInfoEnabled());
+		CHECK(parent->isDebugEnabled());
+
+		// the reset levels inherit the level of the root logger
+		LogManager::getRootLogger()->setLevel(Level::FATAL);
+		LogManager::resetConfiguration();
+		CHECK(child->isDebugEnabled());
+		CHECK(middle->isDebugEnabled());
+		CHECK(repository->getThreshold().equals(Level::ALL));
+
+		return failures;
+	}
+
+	/** Logs one event at each level to <code>logger</code>, returns
+	the number of events <code>appender</code> appended. */
+	int appended(const LoggerPtr& logger, VectorAppender * appender)
+	{
+		appender->messages.clear();
+		appender->levels.clear();
+
+		logger->debug(_T("debug"));
+		logger->info(_T("info"));
+		logger->warn(_T("warn"));
+		logger->error(_T("error"));
+		logger->fatal(_T("fatal"));
+
+		return (int)appender->messages.size();
+	}
+
+	int routeTest()
+	{
+		int failures = 0;
+
+		LoggerPtr parent = Logger::getLogger(_T("route"));
+		LoggerPtr child = Logger::getLogger(_T("route.child"));
+		parent->setLevel(Level::DEBUG);
+		parent->setAdditivity(false);
+
+		VectorAppender * parentAppender = new VectorAppender();
+		AppenderPtr parentAppenderPtr = parentAppender;
+		VectorAppender * childAppender = new VectorAppender();
+		AppenderPtr childAppenderPtr = childAppender;
+
+		parentAppender->setThreshold(Level::WARN);
+		parent->addAppender(parentAppender);
+		child->addAppender(childAppender);
+
+		// each level goes to the appenders whose threshold accepts it
+		CHECK(appended(child, parentAppender) == 3);
+		CHECK(appended(child, childAppender) == 5);
+
+		// a threshold changed after the route was built
+		parentAppender->setThreshold(Level::ERROR);
+		CHECK(appended(child, parentAppender) == 2);
+		childAppender->setThreshold(Level::FATAL);
+		CHECK(appended(child, childAppender) == 1);
+		childAppender->setThreshold(Level::ALL);
+
+		// an appender reachable twice is called once
+		child->addAppender(parentAppender);
+		CHECK(appended(child, parentAppender) == 2);
+		child->removeAppender(parentAppender);
+
+		// the additivity and the appenders of the ancestors
+		child->setAdditivity(false);
+		CHECK(appended(child, parentAppender) == 0);
+		CHECK(appended(child, childAppender) == 5);
+		child->setAdditivity(true);
+		CHECK(appended(child, parentAppender) == 2);
+
+		parent->removeAppender(parentAppender);
+		CHECK(appended(child, parentAppender) == 0);
+		CHECK(appended(child, childAppender) == 5);
+
+		// a level under the logger level never reaches the route
+		child->setLevel(Level::WARN);
+		CHECK(appended(child, childAppender) == 3);
+		child->setLevel(Level::OFF);
+
+		child->removeAppender(childAppender);
+		return failures;
+	}
+
+	int concurrentTest()
+	{
+		int failures = 0;
+		const int knownCount = 50;
+		const int createdCount = 1000;
+
+		LoggerPtr known[knownCount];
+		tstring knownNames[knownCount];
+		for (int k = 0; k < knownCount; k++)
+		{
+			tostringstream name;
+			name << _T("grow.known.") << k;
+			knownNames[k] = name.str();
+			known[k] = Logger::getLogger(knownNames[k]);
+		}
+
+		int before = (int)LogManager::getCurrentLoggers().size();
+
+		// the table grows several times while it is read
+		volatile long mismatches = 0;
+		Semaphore done;
+		Thread * first = new Creator(_T("grow.first."), createdCount,
+			mismatches, done);
+		Thread * second = new Creator(_T("grow.second."), createdCount,
+			mismatches, done);
+		first->start();
+		second->start();
+
+		int finished = 0;
+		while (finished < 2)
+		{
+			for (int k = 0; k < knownCount; k++)
+			{
+				CHECK(Logger::getLogger(knownNames[k]) == known[k]);
+			}
+
+			while (finished < 2 && done.tryWait())
+			{
+				finished++;
+			}
+		}
+
+		CHECK(Atomic::get(&mismatches) == 0);
+		CHECK((int)LogManager::getCurrentLoggers().size()
+			>= before + 2 * createdCount);
+		CHECK(LogManager::exists(_T("grow.first.999")) != 0);
+		CHECK(LogManager::exists(_T("grow.second.0")) != 0);
+		CHECK(LogManager::exists(_T("grow.third.0")) == 0);
+
+		// the loggers created concurrently have the right parent
+		LoggerPtr parent = Logger::getLogger(_T("grow.first"));
+		parent->setLevel(Level::ERROR);
+		CHECK(!Logger::getLogger(_T("grow.first.5"))->isWarnEnabled());
+		CHECK(Logger::getLogger(_T("grow.second.5"))->isWarnEnabled());
+		parent->setLevel(Level::OFF);
+
+		return failures;
+	}
+
+	int snapshotTest()
+	{
+		int failures = 0;
+
+		LoggerPtr logger = Logger::getLogger(_T("snapshot"));
+		logger->setLevel(Level::DEBUG);
+		logger->setAdditivity(false);
+
+		VectorAppender * kept = new VectorAppender();
+		AppenderPtr keptPtr = kept;
+		kept->setName(_T("kept"));
+		VectorAppender * toggled = new VectorAppender();
+		AppenderPtr toggledPtr = toggled;
+		toggled->setName(_T("toggled"));
+
+		// a list of the appenders is not changed by the later updates
+		logger->addAppender(kept);
+		AppenderList appenders = logger->getAllAppenders();
+		logger->addAppender(toggled);
+		CHECK(appenders.size() == 1);
+		CHECK(logger->getAllAppenders().size() == 2);
+		CHECK(logger->getAppender(_T("toggled")) == toggledPtr);
+		CHECK(logger->isAttached(toggledPtr));
+
+		logger->removeAppender(toggled);
+		CHECK(!logger->isAttached(toggledPtr));
+		CHECK(logger->getAppender(_T("toggled")) == 0);
+
+		// the events reach the appender which stays attached while
+		// another one is attached and detached
+		const int count = 2000;
+		Semaphore done;
+		Thread * toggler = new Toggler(logger, toggledPtr, count, done);
+		toggler->start();
+
+		kept->messages.clear();
+		for (int i = 0; i < count; i++)
+		{
+			logger->info(_T("snapshot"));
+		}
+
+		done.wait();
+		CHECK((int)kept->messages.size() == count);
+		CHECK((int)toggled->messages.size() <= count);
+		CHECK(logger->getAllAppenders().size() == 1);
+
+		logger->removeAppender(kept);
+		return failures;
+	}
+}
+
+int hierarchyTest()
+{
+	int failures = 0;
+
+	failures += resetTest();
+	failures += levelTest();
+	failures += routeTest();
+	failures += concurrentTest();
+	failures += snapshotTest();
+
+	return failures;
+}
@@ -0,0 +1,175 @@
+/***************************************************************************
+                loggingeventtest.cpp  -  LoggingEvent stream tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/ndc.h>
+#include <log4cxx/mdc.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/serversocket.h>
+#include <log4cxx/helpers/socket.h>
+#include <log4cxx/helpers/socketoutputstream.h>
+#include <log4cxx/helpers/socketinputstream.h>
+#include <log4cxx/helpers/socketimpl.h>
+#include <memory>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace
+{
+	/** The first loopback port tried for the events. */
+	const int FIRST_PORT = 4571;
+
+	/**
+	A connection through the loopback interface. The bytes written are
+	read once the writing end is closed, since SocketInputStream reads
+	ahead of the event.
+	*/
+	class Connection
+	{
+	public:
+		Connection(ServerSocket& server)
+		{
+			SocketPtr client = new Socket(_T("127.0.0.1"),
+				server.getLocalPort());
+			accepted = server.accept();
+			os = client->getOutputStream();
+		}
+
+		SocketOutputStreamPtr os;
+
+		/** Closes the writing end and returns the reading one. */
+		SocketInputStreamPtr close()
+		{
+			os->flush();
+			os->close();
+			os = 0;
+			return accepted->getInputStream();
+		}
+
+	protected:
+		SocketPtr accepted;
+	};
+
+	/** Returns true if reading an event from <code>is</code> is
+	rejected. */
+	bool rejected(SocketInputStreamPtr is)
+	{
+		try
+		{
+			LoggingEvent event;
+			event.read(is);
+		}
+		catch (SocketException&)
+		{
+			return true;
+		}
+
+		return false;
+	}
+}
+
+int loggingEventTest()
+{
+	int failures = 0;
+	LoggerPtr logger = Logger::getLogger(_T("loggingevent"));
+
+	// the assignment keeps the capacity of the message
+	LoggingEvent reused(logger, Level::INFO, tstring(100, _T('r')));
+	LoggingEvent shorter(logger, Level::ERROR, _T("short"), "short.cpp", 3);
+	tstring::size_type capacity = reused.getRenderedMessage().capacity();
+	reused = shorter;
+	CHECK(reused.getRenderedMessage() == _T("short"));
+	CHECK(reused.getRenderedMessage().capacity() == capacity);
+	CHECK(reused.getLevel().equals(Level::ERROR));
+	CHECK(reused.getLine() == 3);
+
+	std::auto_ptr<ServerSocket> server;
+	for (int port = FIRST_PORT; server.get() == 0 && port < FIRST_PORT + 100;
+		port++)
+	{
+		try
+		{
+			server.reset(new ServerSocket(port));
+		}
+		catch (SocketException&)
+		{
+		}
+	}
+
+	CHECK(server.get() != 0);
+	if (server.get() == 0)
+	{
+		return failures;
+	}
+
+	// an event comes back with its contexts
+	NDC::push(_T("request"));
+	MDC::put(_T("user"), _T("alice"));
+	LoggingEvent sent(logger, Level::WARN, _T("sent"), "dir/file.cpp", 42);
+	NDC::pop();
+	MDC::clear();
+
+	Connection connection(*server);
+	sent.write(connection.os);
+
+	LoggingEvent received;
+	received.read(connection.close());
+	CHECK(received.getLoggerName() == _T("loggingevent"));
+	CHECK(received.getLevel().equals(Level::WARN));
+	CHECK(received.getRenderedMessage() == _T("sent"));
+	CHECK(received.getTimeStamp() == sent.getTimeStamp());
+	CHECK(received.getMicroseconds() == sent.getMicroseconds());
+	CHECK(received.getLine() == 42);
+	CHECK(received.getNDC() == _T("request"));
+	CHECK(received.getMDC(_T("user")) == _T("alice"));
+
+	// a long message is truncated, the fields after it are intact
+	LoggingEvent longEvent(logger, Level::INFO, tstring(3000, _T('x')),
+		"file.cpp", 7);
+
+	Connection longConnection(*server);
+	longEvent.write(longConnection.os);
+
+	received.read(longConnection.close());
+	CHECK(received.getRenderedMessage() == tstring(1024, _T('x')));
+	CHECK(received.getLine() == 7);
+
+	// a version it does not know, such as the length of the logger
+	// name which began the unversioned format
+	Connection unversioned(*server);
+	unversioned.os->write((tstring::size_type)12);
+	unversioned.os->write(_T("loggingevent"), 12 * sizeof(TCHAR));
+	CHECK(rejected(unversioned.close()));
+
+	// too many MDC keys
+	for (int i = 0; i < 300; i++)
+	{
+		MDC::put(tstring(1, (TCHAR)(_T('a') + i % 26)) +
+			tstring(i / 26 + 1, _T('k')), _T("v"));
+	}
+	LoggingEvent crowded(logger, Level::INFO, _T("crowded"));
+	MDC::clear();
+
+	Connection crowdedConnection(*server);
+	crowded.write(crowdedConnection.os);
+	CHECK(rejected(crowdedConnection.close()));
+
+	return failures;
+}
@@ -0,0 +1,142 @@
+/***************************************************************************
+       mappedfileappendertest.cpp  -  MappedFileAppender tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/mappedfileappender.h>
+#include <log4cxx/simplelayout.h>
+#include <fstream>
+#include <iterator>
+#include <stdio.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace
+{
+	/** Returns the content of the file <code>fileName</code>. */
+	tstring readFile(const tstring& fileName)
+	{
+		std::basic_ifstream<TCHAR> file(T2A(fileName.c_str()));
+		return tstring(std::istreambuf_iterator<TCHAR>(file),
+			std::istreambuf_iterator<TCHAR>());
+	}
+
+	/** Logs the INFO events <code>prefix</code> from
+	<code>first</code> to <code>last</code>, returns the lines
+	SimpleLayout writes for them. */
+	tstring log(const LoggerPtr& logger, const tstring& prefix,
+		int first, int last)
+	{
+		tostringstream oss;
+		for (int i = first; i <= last; i++)
+		{
+			tostringstream message;
+			message << prefix << i;
+			logger->info(message.str());
+			oss << _T("INFO - ") << message.str() << std::endl;
+		}
+
+		return oss.str();
+	}
+
+	/** Returns an appender mapping <code>fileName</code> by segments
+	of a page, and a logger appending to it. */
+	MappedFileAppender * mappedAppender(const tstring& fileName,
+		bool append, LoggerPtr& logger)
+	{
+		MappedFileAppender * appender = new MappedFileAppender();
+		appender->setLayout(new SimpleLayout());
+		appender->setFile(fileName);
+		appender->setAppend(append);
+		appender->setSegmentSize(1);
+
+		logger = Logger::getLogger(_T("mappedfileappender"));
+		logger->setAdditivity(false);
+		logger->setLevel(Level::DEBUG);
+		logger->removeAllAppenders();
+		logger->addAppender(appender);
+		return appender;
+	}
+}
+
+int mappedFileAppenderTest()
+{
+	int failures = 0;
+	const tstring fileName = _T("console_test_mapped.log");
+	const tstring backupName = fileName + _T(".1");
+	LoggerPtr logger;
+
+	// the text crosses several segments, it is in the file as soon as
+	// it is copied, and the rest of the last segment is given back
+	// when the file is closed
+	MappedFileAppender * appender = mappedAppender(fileName, false, logger);
+	appender->activateOptions();
+	tstring expected = log(logger, _T("m"), 0, 999);
+
+	tstring content = readFile(fileName);
+	CHECK(content.size() >= expected.size());
+	CHECK(content.substr(0, expected.size()) == expected);
+
+	logger->removeAllAppenders();
+	CHECK(readFile(fileName) == expected);
+
+	// the file is appended to after its text
+	appender = mappedAppender(fileName, true, logger);
+	appender->setSyncPolicy(FileAppender::SYNC_BATCH);
+	appender->activateOptions();
+	expected += log(logger, _T("a"), 0, 2);
+	logger->removeAllAppenders();
+	CHECK(readFile(fileName) == expected);
+
+#if defined(HAVE_SYS_MMAN_H) && !defined(UNICODE)
+	// the zeros of a file which was not truncated are skipped
+	{
+		std::ofstream zeros(T2A(fileName.c_str()),
+			std::ios::out|std::ios::app|std::ios::binary);
+		zeros << std::string(10000, '\0');
+	}
+
+	appender = mappedAppender(fileName, true, logger);
+	appender->activateOptions();
+	expected += log(logger, _T("z"), 0, 2);
+	logger->removeAllAppenders();
+	CHECK(readFile(fileName) == expected);
+#endif
+
+	// the file rolls over once it reaches MaxFileSize
+	appender = mappedAppender(fileName, false, logger);
+	appender->setMaxFileSize(_T("4KB"));
+	appender->setMaxBackupIndex(1);
+	appender->activateOptions();
+	expected = log(logger, _T("r"), 0, 999);
+	logger->removeAllAppenders();
+
+	tstring backup = readFile(backupName);
+	content = readFile(fileName);
+	CHECK(backup.size() >= 4096);
+	CHECK(content.size() < 4096);
+	CHECK(expected.size() >= backup.size() + content.size());
+	CHECK(backup + content ==
+		expected.substr(expected.size() - backup.size() - content.size()));
+
+	::remove(T2A(fileName.c_str()));
+	::remove(T2A(backupName.c_str()));
+
+	return failures;
+}
@@ -0,0 +1,89 @@
+/***************************************************************************
+                          mdctest.cpp  -  MDC tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/mdc.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <memory>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+int mdcTest()
+{
+	int failures = 0;
+	LoggerPtr logger = Logger::getLogger(_T("mdc"));
+
+	MDC::clear();
+	CHECK(MDC::getCurrentMap() == 0);
+	CHECK(MDC::get(_T("user")) == _T(""));
+
+	// a map no event references is modified in place
+	MDC::put(_T("user"), _T("alice"));
+	MDC::Map * map = MDC::getCurrentMap();
+	CHECK(map != 0 && !map->isShared());
+	MDC::put(_T("session"), _T("s1"));
+	CHECK(MDC::getCurrentMap() == map);
+
+	// an event shares the map of the thread, which is copied when the
+	// thread changes it afterwards
+	LoggingEvent first(logger, Level::INFO, _T("first"));
+	CHECK(first.getMDCMap() == map);
+	CHECK(map->isShared());
+
+	MDC::put(_T("user"), _T("bob"));
+	MDC::put(_T("request"), _T("7"));
+	CHECK(MDC::getCurrentMap() != map);
+	LoggingEvent second(logger, Level::INFO, _T("second"));
+
+	MDC::remove(_T("user"));
+	LoggingEvent third(logger, Level::INFO, _T("third"));
+
+	CHECK(first.getMDC(_T("user")) == _T("alice"));
+	CHECK(first.getMDC(_T("request")) == _T(""));
+	CHECK(second.getMDC(_T("user")) == _T("bob"));
+	CHECK(second.getMDC(MDC::getKeyId(_T("request"))) == _T("7"));
+	CHECK(second.getMDC(_T("session")) == _T("s1"));
+	CHECK(third.getMDC(_T("user")) == _T(""));
+	CHECK(third.getMDC(_T("request")) == _T("7"));
+	CHECK(MDC::get(_T("user")) == _T(""));
+	CHECK(MDC::get(_T("request")) == _T("7"));
+
+	std::auto_ptr<LoggingEvent> copy(second.copy());
+	MDC::clear();
+	CHECK(MDC::getCurrentMap() == 0);
+	CHECK(copy->getMDC(_T("user")) == _T("bob"));
+	CHECK(second.getMDC(_T("user")) == _T("bob"));
+
+	// the keys received from another process are not registered
+	CHECK(MDC::findKeyId(_T("mdc.remote.only")) == -1);
+	MDC::MapPtr remote = new MDC::Map();
+	remote->putRemote(_T("mdc.remote.only"), _T("r"));
+	remote->putRemote(_T("user"), _T("carol"));
+	CHECK(MDC::findKeyId(_T("mdc.remote.only")) == -1);
+	CHECK(remote->size() == 2);
+
+	const tstring * value = remote->get(_T("mdc.remote.only"));
+	CHECK(value != 0 && *value == _T("r"));
+	value = remote->get(MDC::getKeyId(_T("user")));
+	CHECK(value != 0 && *value == _T("carol"));
+	CHECK(remote->get(_T("request")) == 0);
+
+	return failures;
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+                          ndctest.cpp  -  NDC tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/ndc.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/thread.h>
+#include <memory>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace
+{
+	/** Inherits a context, pushes its own frames and keeps the context
+	of an event, then posts <code>done</code>. */
+	class Child : public Thread
+	{
+	public:
+		Child(NDC::Stack * stack, tstring& ndc, Semaphore& done)
+		: stack(stack), ndc(ndc), done(done)
+		{
+		}
+
+		void run()
+		{
+			NDC::inherit(stack);
+			NDC::push(_T("child"));
+
+			LoggingEvent event(Logger::getLogger(_T("ndc")), Level::INFO,
+				_T("child"));
+			NDC::pop();
+			NDC::push(_T("other"));
+			ndc = event.getNDC();
+
+			NDC::remove();
+			done.post();
+		}
+
+	protected:
+		NDC::Stack * stack;
+		tstring& ndc;
+		Semaphore& done;
+	};
+}
+
+int ndcTest()
+{
+	int failures = 0;
+	LoggerPtr logger = Logger::getLogger(_T("ndc"));
+
+	NDC::clear();
+	CHECK(NDC::getDepth() == 0);
+	CHECK(NDC::get() == _T(""));
+	CHECK(NDC::getCurrentContext() == 0);
+
+	NDC::push(_T("a"));
+	NDC::push(_T("b"));
+	LoggingEvent first(logger, Level::INFO, _T("first"));
+	CHECK(first.getNDC() == _T("a b"));
+
+	// the events share the frames of the thread, the frames pushed
+	// and popped afterwards do not change them
+	NDC::push(_T("c"));
+	LoggingEvent second(logger, Level::INFO, _T("second"));
+	CHECK(NDC::getCurrentContext()->getParent()->getDepth() == 2);
+	CHECK(NDC::pop() == _T("c"));
+	CHECK(NDC::peek() == _T("b"));
+	NDC::push(_T("d"));
+	CHECK(NDC::get() == _T("a b d"));
+	CHECK(NDC::getDepth() == 3);
+
+	std::auto_ptr<LoggingEvent> copy(second.copy());
+	NDC::clear();
+	CHECK(first.getNDC() == _T("a b"));
+	CHECK(second.getNDC() == _T("a b c"));
+	CHECK(copy->getNDC() == _T("a b c"));
+	CHECK(NDC::pop() == _T(""));
+
+	// a child thread inherits the context, and changes it on its own
+	NDC::push(_T("parent"));
+	tstring childNDC;
+	Semaphore done;
+	Thread * child = new Child(NDC::cloneStack(), childNDC, done);
+	child->start();
+	done.wait();
+	CHECK(childNDC == _T("parent child"));
+	CHECK(NDC::get() == _T("parent"));
+
+	NDC::remove();
+	CHECK(NDC::getDepth() == 0);
+
+	return failures;
+}
@@ -0,0 +1,260 @@
+/***************************************************************************
+             patternlayouttest.cpp  -  compiled PatternLayout tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/ndc.h>
+#include <log4cxx/mdc.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/spi/callsite.h>
+#include <log4cxx/helpers/patternparser.h>
+#include <log4cxx/helpers/patternconverter.h>
+#include <log4cxx/helpers/dateformat.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace
+{
+	/** Returns <code>event</code> formatted by the compiled program
+	of <code>pattern</code>. */
+	tstring compiled(const tstring& pattern, const LoggingEvent& event)
+	{
+		PatternLayout layout(pattern);
+		tstring output;
+		layout.format(output, event);
+		return output;
+	}
+
+	/** Returns <code>event</code> formatted by the chain of converters
+	of <code>pattern</code>, which the program must match. */
+	tstring converted(const tstring& pattern, const LoggingEvent& event)
+	{
+		tostringstream output;
+		PatternConverterPtr head = PatternParser(pattern).parse();
+		for (PatternConverter * c = head; c != 0; c = c->next)
+		{
+			c->format(output, event);
+		}
+
+		return output.str();
+	}
+
+	/** Counts the failures of <code>pattern</code>, which must give
+	<code>expected</code> either way. */
+	int checkPattern(const tstring& pattern, const LoggingEvent& event,
+		const tstring& expected)
+	{
+		int failures = 0;
+		tstring output = compiled(pattern, event);
+
+		CHECK(output == expected);
+		CHECK(output == converted(pattern, event));
+
+		return failures;
+	}
+
+	int modifierTest()
+	{
+		int failures = 0;
+
+		NDC::push(_T("ctx"));
+		MDC::put(_T("user"), _T("alice"));
+		LoggingEvent event(Logger::getLogger(_T("pattern.layout.test")),
+			Level::INFO, _T("hello"));
+		NDC::pop();
+		MDC::clear();
+
+		failures += checkPattern(_T("%m"), event, _T("hello"));
+		failures += checkPattern(_T("100%% %m"), event, _T("100% hello"));
+
+		// the minimum width pads on the left, or on the right if
+		// left-justified
+		failures += checkPattern(_T("[%10m]"), event, _T("[     hello]"));
+		failures += checkPattern(_T("[%-10m]"), event, _T("[hello     ]"));
+		failures += checkPattern(_T("[%5p]"), event, _T("[ INFO]"));
+		failures += checkPattern(_T("[%-6p]"), event, _T("[INFO  ]"));
+		failures += checkPattern(_T("[%3m]"), event, _T("[hello]"));
+
+		// the maximum width keeps the end of the field
+		failures += checkPattern(_T("[%.3m]"), event, _T("[llo]"));
+		failures += checkPattern(_T("[%.3p]"), event, _T("[NFO]"));
+		failures += checkPattern(_T("[%.6c]"), event, _T("[t.test]"));
+		failures += checkPattern(_T("[%-7.9c{1}]"), event, _T("[test   ]"));
+		failures += checkPattern(_T("[%8.10m]"), event, _T("[   hello]"));
+
+		// the precision of the logger name
+		failures += checkPattern(_T("%c"), event, _T("pattern.layout.test"));
+		failures += checkPattern(_T("%c{2}"), event, _T("layout.test"));
+		failures += checkPattern(_T("%c{5}"), event,
+			_T("pattern.layout.test"));
+		failures += checkPattern(_T("[%-6c{1}]"), event, _T("[test  ]"));
+
+		// the contexts of the event
+		failures += checkPattern(_T("%x %X{user}"), event, _T("ctx alice"));
+		failures += checkPattern(_T("[%7X{user}][%X{none}]"), event,
+			_T("[  alice][]"));
+		failures += checkPattern(_T("[%3x]"), event, _T("[ctx]"));
+
+		// several fields in a row
+		failures += checkPattern(_T("%-5p %c{1} - %m%n"), event,
+			_T("INFO  test - hello\n"));
+
+		return failures;
+	}
+
+	/** Returns <code>time</code> and <code>microseconds</code> formatted
+	by <code>format</code>. */
+	tstring formatDate(DateFormat& format, time_t time, long microseconds)
+	{
+		tstring output;
+		format.format(output, time, microseconds);
+		return output;
+	}
+
+	int millisecondTest()
+	{
+		int failures = 0;
+
+		// 2001-09-09 01:46:40 UTC
+		const time_t time = 1000000000;
+
+		DateFormat format(_T("%Y-%m-%d %H:%M:%S,SSS"));
+		CHECK(formatDate(format, time, 5000)
+			== _T("2001-09-09 01:46:40,005"));
+
+		// the same second comes from the cache
+		CHECK(formatDate(format, time, 999999)
+			== _T("2001-09-09 01:46:40,999"));
+
+		// the next second replaces it, the previous one comes back
+		CHECK(formatDate(format, time + 1, 0)
+			== _T("2001-09-09 01:46:41,000"));
+		CHECK(formatDate(format, time + 1, 123456)
+			== _T("2001-09-09 01:46:41,123"));
+		CHECK(formatDate(format, time, 42000)
+			== _T("2001-09-09 01:46:40,042"));
+		CHECK(formatDate(format, time + 60, 0)
+			== _T("2001-09-09 01:47:40,000"));
+
+		// the text after the fraction is cached too
+		DateFormat suffix(_T("%M:%S.SSS (%H)"));
+		CHECK(formatDate(suffix, time, 7000) == _T("46:40.007 (01)"));
+		CHECK(formatDate(suffix, time, 8000) == _T("46:40.008 (01)"));
+		CHECK(formatDate(suffix, time + 3600, 8000) == _T("46:40.008 (02)"));
+
+		// without a fraction
+		DateFormat seconds(_T("%H:%M:%S"));
+		CHECK(formatDate(seconds, time, 5000) == _T("01:46:40"));
+		CHECK(formatDate(seconds, time + 1, 5000) == _T("01:46:41"));
+
+		// the compiled %d matches its converter
+		LoggingEvent event(Logger::getLogger(_T("pattern")), Level::INFO,
+			_T("date"));
+		tstring pattern = _T("[%d{%H:%M:%S,SSS}] %m");
+		CHECK(compiled(pattern, event) == converted(pattern, event));
+		CHECK(compiled(pattern, event).size() == 19);
+
+		return failures;
+	}
+
+	int microsecondTest()
+	{
+		int failures = 0;
+		const time_t time = 1000000000;
+
+		DateFormat format(_T("%H:%M:%S.SSSSSS"));
+		CHECK(formatDate(format, time, 5) == _T("01:46:40.000005"));
+		CHECK(formatDate(format, time, 999999) == _T("01:46:40.999999"));
+		CHECK(formatDate(format, time + 1, 120000) == _T("01:46:41.120000"));
+		CHECK(formatDate(format, time, 0) == _T("01:46:40.000000"));
+
+		// only the first run of S is the fraction
+		DateFormat twice(_T("SSS %S SSS"));
+		CHECK(formatDate(twice, time, 7000) == _T("007 40 SSS"));
+
+		// the events keep their microseconds
+		LoggingEvent event(Logger::getLogger(_T("pattern")), Level::INFO,
+			_T("date"));
+		CHECK(event.getMicroseconds() >= 0 && event.getMicroseconds() < 1000000);
+
+		tstring pattern = _T("%d{SSSSSS}");
+		tstring micros = compiled(pattern, event);
+		CHECK(micros == converted(pattern, event));
+		CHECK(micros.size() == 6);
+		CHECK(ttol(micros.c_str()) == event.getMicroseconds());
+
+		return failures;
+	}
+
+	int callSiteTest()
+	{
+		int failures = 0;
+		LoggerPtr logger = Logger::getLogger(_T("pattern"));
+
+		// the location of a statement comes from its descriptor
+		const int line = __LINE__ + 1;
+		static CallSite site = LOG4CXX_CALL_SITE_INIT(LOG4CXX_LEVEL_INFO);
+		LoggingEvent event(logger, Level::INFO, _T("site"), site);
+
+		tostringstream location;
+		location << _T("patternlayouttest.cpp(") << line << _T(")");
+		tostringstream lineText;
+		lineText << line;
+
+		failures += checkPattern(_T("%F"), event, _T("patternlayouttest.cpp"));
+		failures += checkPattern(_T("%L"), event, lineText.str());
+		failures += checkPattern(_T("%l"), event, location.str());
+		failures += checkPattern(_T("%M"), event, _T("callSiteTest"));
+		failures += checkPattern(_T("[%-14M]"), event, _T("[callSiteTest  ]"));
+		failures += checkPattern(_T("[%.4F]"), event, _T("[.cpp]"));
+
+		// an explicit file and line, without function
+		LoggingEvent explicitEvent(logger, Level::INFO, _T("explicit"),
+			"dir/sub/explicit.cpp", 12);
+		failures += checkPattern(_T("%F:%L [%M]"), explicitEvent,
+			_T("explicit.cpp:12 []"));
+
+		// no location at all
+		LoggingEvent none(logger, Level::INFO, _T("none"));
+		failures += checkPattern(_T("[%F][%M]"), none, _T("[][]"));
+
+		// the identifier depends on the file and the line only
+		CallSite same = { "other/patternlayouttest.cpp", 0, line, 0, 0, 0, 0 };
+		CallSite next = { site.file, 0, line + 1, 0, 0, 0, 0 };
+		CHECK(site.getId() != 0);
+		CHECK(site.getId() == site.getId());
+		CHECK(same.getId() == site.getId());
+		CHECK(next.getId() != site.getId());
+
+		return failures;
+	}
+}
+
+int patternLayoutTest()
+{
+	int failures = 0;
+
+	failures += modifierTest();
+	failures += millisecondTest();
+	failures += microsecondTest();
+	failures += callSiteTest();
+
+	return failures;
+}
@@ -0,0 +1,225 @@
+/***************************************************************************
+             ratelimitfiltertest.cpp  -  RateLimitFilter tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include "vectorappender.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/varia/ratelimitfilter.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/thread.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+using namespace log4cxx::varia;
+
+namespace
+{
+	const tstring SUPPRESSED = _T("Suppressed ");
+
+	void hot(const LoggerPtr& logger, int i)
+	{
+		LOG4CXX_INFO(logger, _T("hot ") << i);
+	}
+
+	void cold(const LoggerPtr& logger, int i)
+	{
+		LOG4CXX_WARN(logger, _T("cold ") << i);
+	}
+
+	/** Returns the number of events the summaries of
+	<code>appender</code> report. */
+	long suppressed(const VectorAppender * appender)
+	{
+		long total = 0;
+		for (size_t i = 0; i < appender->messages.size(); i++)
+		{
+			const tstring& text = appender->messages[i];
+			if (text.compare(0, SUPPRESSED.size(), SUPPRESSED) == 0)
+			{
+				tstring count = text.substr(SUPPRESSED.size());
+				total += OptionConverter::toInt(
+					count.substr(0, count.find(_T(' '))), 0);
+			}
+		}
+
+		return total;
+	}
+
+	/** Returns the level of the first message starting with
+	<code>prefix</code>, -1 if none. */
+	int levelOf(const VectorAppender * appender, const tstring& prefix)
+	{
+		for (size_t i = 0; i < appender->messages.size(); i++)
+		{
+			if (appender->messages[i].compare(0, prefix.size(), prefix) == 0)
+			{
+				return appender->levels[i];
+			}
+		}
+
+		return -1;
+	}
+
+	int locationTest()
+	{
+		int failures = 0;
+
+		LoggerPtr logger = Logger::getLogger(_T("ratelimit"));
+		logger->setAdditivity(false);
+		logger->removeAllAppenders();
+
+		// the summaries only go to the appender of the filter
+		VectorAppender * limited = new VectorAppender();
+		AppenderPtr limitedPtr = limited;
+		VectorAppender * other = new VectorAppender();
+		AppenderPtr otherPtr = other;
+
+		RateLimitFilter * filter = new RateLimitFilter();
+		FilterPtr filterPtr = filter;
+		filter->setBurst(3);
+		filter->setRate(1);
+		limited->addFilter(filterPtr);
+
+		logger->addAppender(limitedPtr);
+		logger->addAppender(otherPtr);
+
+		for (int i = 0; i < 10; i++)
+		{
+			hot(logger, i);
+		}
+
+		CHECK(limited->count(_T("hot ")) == 3);
+		CHECK(other->count(_T("hot ")) == 10);
+		CHECK(limited->count(SUPPRESSED) == 0);
+
+		// once a second has passed, the first event of another statement
+		// reports the events denied before
+		Thread::sleep(1100);
+		for (int i = 0; i < 10; i++)
+		{
+			cold(logger, i);
+		}
+
+		CHECK(limited->count(_T("cold ")) == 3);
+		CHECK(limited->count(_T("Suppressed 7 events from ")) == 1);
+		CHECK(levelOf(limited, SUPPRESSED) == Level::INFO_INT);
+
+		// the last summary is reported when the appender is closed
+		logger->removeAllAppenders();
+		CHECK(limited->count(SUPPRESSED) == 2);
+		CHECK(suppressed(limited) == 14);
+		CHECK(other->count(SUPPRESSED) == 0);
+		CHECK(other->messages.size() == 20);
+
+		return failures;
+	}
+
+	int samplingTest()
+	{
+		int failures = 0;
+
+		LoggerPtr logger = Logger::getLogger(_T("ratelimit.sampled"));
+		logger->setAdditivity(false);
+		logger->removeAllAppenders();
+
+		VectorAppender * limited = new VectorAppender();
+		AppenderPtr limitedPtr = limited;
+		RateLimitFilter * filter = new RateLimitFilter();
+		FilterPtr filterPtr = filter;
+		filter->setBurst(1);
+		filter->setSampleRate(3);
+		limited->addFilter(filterPtr);
+		logger->addAppender(limitedPtr);
+
+		// one of every 3 events over the limit is let through
+		for (int i = 0; i < 10; i++)
+		{
+			hot(logger, i);
+		}
+
+		logger->removeAllAppenders();
+		CHECK(limited->count(_T("hot ")) == 4);
+		CHECK(suppressed(limited) == 6);
+
+		return failures;
+	}
+
+	int loggerTest()
+	{
+		int failures = 0;
+
+		VectorAppender * limited = new VectorAppender();
+		AppenderPtr limitedPtr = limited;
+		RateLimitFilter * filter = new RateLimitFilter();
+		FilterPtr filterPtr = filter;
+		filter->setKeyByLogger(true);
+		filter->setBurst(2);
+		filter->setRate(1);
+		limited->addFilter(filterPtr);
+
+		// more loggers than the table of the filter holds, the ones
+		// beyond share one bucket
+		const int count = 3000;
+		std::vector<LoggerPtr> loggers;
+		for (int i = 0; i < count; i++)
+		{
+			tostringstream name;
+			name << _T("ratelimit.k") << i;
+			LoggerPtr logger = Logger::getLogger(name.str());
+			logger->setAdditivity(false);
+			logger->removeAllAppenders();
+			logger->addAppender(limitedPtr);
+			loggers.push_back(logger);
+		}
+
+		for (int round = 0; round < 5; round++)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				loggers[i]->info(_T("m"));
+			}
+		}
+
+		limited->close();
+		for (int i = 0; i < count; i++)
+		{
+			loggers[i]->removeAppender(limitedPtr);
+		}
+
+		// every event is either logged or reported
+		long logged = limited->count(_T("m"));
+		CHECK(logged + suppressed(limited) == 5 * count);
+		CHECK(logged < 5 * count);
+		CHECK(limited->count(_T("Suppressed 3 events of logger [")) > 0);
+		CHECK(limited->count(SUPPRESSED) ==
+			limited->count(_T("Suppressed 3 events of logger [")) + 1);
+
+		return failures;
+	}
+}
+
+int rateLimitFilterTest()
+{
+	int failures = 0;
+
+	failures += locationTest();
+	failures += samplingTest();
+	failures += loggerTest();
+
+	return failures;
+}
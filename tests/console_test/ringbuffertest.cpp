@@ -0,0 +1,399 @@
+/***************************************************************************
+                 ringbuffertest.cpp  -  RingBuffer and AsyncAppender tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include "vectorappender.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/asyncappender.h>
+#include <log4cxx/helpers/ringbuffer.h>
+#include <log4cxx/helpers/thread.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace
+{
+	tstring message(const tstring& prefix, int i)
+	{
+		tostringstream oss;
+		oss << prefix << i;
+		return oss.str();
+	}
+
+	/** Logs <code>count</code> numbered events of its own, then posts
+	<code>done</code>. The thread deletes itself when it ends. */
+	class Producer : public Thread
+	{
+	public:
+		Producer(const LoggerPtr& logger, const tstring& prefix, int count,
+			Semaphore& done)
+		: logger(logger), prefix(prefix), count(count), done(done)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < count; i++)
+			{
+				logger->info(message(prefix, i));
+			}
+
+			done.post();
+		}
+
+	protected:
+		LoggerPtr logger;
+		tstring prefix;
+		int count;
+		Semaphore& done;
+	};
+
+	/** Returns true if the events with <code>prefix</code> appear
+	in order, from <code>first</code> to <code>last</code>. */
+	bool inOrder(const VectorAppender * appender, const tstring& prefix,
+		int first, int last)
+	{
+		int expected = first;
+		for (size_t i = 0; i < appender->messages.size(); i++)
+		{
+			const tstring& text = appender->messages[i];
+			if (text.compare(0, prefix.size(), prefix) != 0)
+			{
+				continue;
+			}
+
+			if (text != message(prefix, expected))
+			{
+				return false;
+			}
+
+			expected++;
+		}
+
+		return expected == last + 1;
+	}
+
+	/** Returns the messages starting with <code>prefix</code>. */
+	std::vector<tstring> select(const VectorAppender * appender,
+		const tstring& prefix)
+	{
+		std::vector<tstring> selected;
+		for (size_t i = 0; i < appender->messages.size(); i++)
+		{
+			const tstring& text = appender->messages[i];
+			if (text.compare(0, prefix.size(), prefix) == 0)
+			{
+				selected.push_back(text);
+			}
+		}
+
+		return selected;
+	}
+
+	/** Appends the events <code>prefix</code> from <code>first</code>
+	to <code>last</code> to <code>events</code>. */
+	std::vector<tstring>& numbered(std::vector<tstring>& events,
+		const tstring& prefix, int first, int last)
+	{
+		for (int i = first; i <= last; i++)
+		{
+			events.push_back(message(prefix, i));
+		}
+
+		return events;
+	}
+
+	/** Returns the level of the first message starting with
+	<code>prefix</code>, -1 if none. */
+	int levelOf(const VectorAppender * appender, const tstring& prefix)
+	{
+		for (size_t i = 0; i < appender->messages.size(); i++)
+		{
+			if (appender->messages[i].compare(0, prefix.size(), prefix) == 0)
+			{
+				return appender->levels[i];
+			}
+		}
+
+		return -1;
+	}
+
+	LoggerPtr isolatedLogger(const tstring& name, const AppenderPtr& appender)
+	{
+		LoggerPtr logger = Logger::getLogger(name);
+		logger->setAdditivity(false);
+		logger->removeAllAppenders();
+		logger->addAppender(appender);
+		return logger;
+	}
+
+	/** Records the size of the batches it is handed. */
+	class BatchAppender : public GateAppender
+	{
+	public:
+		std::vector<int> batches;
+
+	protected:
+		void appendBatch(const LoggingEventList& events)
+		{
+			batches.push_back((int)events.size());
+			GateAppender::appendBatch(events);
+		}
+	};
+
+	/**
+	Logs e0, which the attached appender holds while e1 to e10 fill a
+	buffer of 4 events, then lets the events through and closes the
+	appender. Returns the number of events discarded.
+	*/
+	long overflow(GateAppender * gate, bool lockFree, int policy)
+	{
+		AsyncAppender * async = new AsyncAppender();
+		AppenderPtr asyncPtr = async;
+		async->setName(_T("overflow"));
+		async->setLockFree(lockFree);
+		async->setBufferSize(4);
+		async->setOverflowPolicy(policy);
+		async->addAppender(gate);
+		async->activateOptions();
+
+		LoggerPtr logger = isolatedLogger(_T("overflow"), async);
+		logger->info(_T("e0"));
+		gate->entered.wait();
+
+		for (int i = 1; i <= 10; i++)
+		{
+			logger->info(message(_T("e"), i));
+		}
+
+		long discarded = async->getDiscardedCount();
+
+		gate->open = true;
+		gate->gate.post();
+		async->close();
+		logger->removeAllAppenders();
+
+		return discarded;
+	}
+
+	int overflowTest(bool lockFree)
+	{
+		int failures = 0;
+		const tstring summary = _T("AsyncAppender [overflow] discarded ");
+
+		// the newest events are discarded, the first ones are kept. e0
+		// no longer takes up a slot while it is dispatched
+		const int kept = 4;
+		std::vector<tstring> expected;
+		numbered(expected, _T("e"), 0, kept);
+
+		GateAppender * gate = new GateAppender();
+		AppenderPtr gatePtr = gate;
+		long discarded = overflow(gate, lockFree, AsyncAppender::DROP_NEWEST);
+		CHECK(discarded == 10 - kept);
+		CHECK(select(gate, _T("e")) == expected);
+		CHECK(gate->count(summary + message(_T(""), 10 - kept)
+			+ _T(" events.")) == 1);
+		CHECK(levelOf(gate, summary) == Level::WARN_INT);
+
+		// the oldest events are discarded, the last ones are kept
+		expected.clear();
+		numbered(numbered(expected, _T("e"), 0, 0), _T("e"), 7, 10);
+
+		gate = new GateAppender();
+		gatePtr = gate;
+		discarded = overflow(gate, lockFree, AsyncAppender::DROP_OLDEST);
+		CHECK(discarded == 10 - kept);
+		CHECK(select(gate, _T("e")) == expected);
+		CHECK(gate->count(summary) == 1);
+
+		// INFO is below the default WARN threshold, it is discarded
+		expected.clear();
+		numbered(expected, _T("e"), 0, kept);
+
+		gate = new GateAppender();
+		gatePtr = gate;
+		discarded = overflow(gate, lockFree,
+			AsyncAppender::DISCARD_BELOW_LEVEL);
+		CHECK(discarded == 10 - kept);
+		CHECK(select(gate, _T("e")) == expected);
+
+		return failures;
+	}
+
+	int blockingTest(bool lockFree)
+	{
+		int failures = 0;
+
+		// a small buffer wraps around many times
+		VectorAppender * vector = new VectorAppender();
+		AppenderPtr vectorPtr = vector;
+		AsyncAppender * async = new AsyncAppender();
+		AppenderPtr asyncPtr = async;
+		async->setLockFree(lockFree);
+		async->setBufferSize(8);
+		async->addAppender(vectorPtr);
+		async->activateOptions();
+
+		LoggerPtr logger = isolatedLogger(_T("blocking"), async);
+
+		const int count = 5000;
+		Semaphore done;
+		for (int i = 0; i < 4; i++)
+		{
+			Thread * producer = new Producer(logger,
+				message(_T("p"), i) + _T("-"), count, done);
+			producer->start();
+		}
+
+		for (int i = 0; i < 4; i++)
+		{
+			done.wait();
+		}
+
+		async->close();
+		logger->removeAllAppenders();
+
+		// nothing is lost, and the events of a thread keep their order
+		CHECK(vector->messages.size() == 4 * count);
+		CHECK(async->getDiscardedCount() == 0);
+		for (int i = 0; i < 4; i++)
+		{
+			CHECK(inOrder(vector, message(_T("p"), i) + _T("-"),
+				0, count - 1));
+		}
+
+		return failures;
+	}
+
+	int batchTest(bool lockFree)
+	{
+		int failures = 0;
+
+		BatchAppender * batch = new BatchAppender();
+		AppenderPtr batchPtr = batch;
+		AsyncAppender * async = new AsyncAppender();
+		AppenderPtr asyncPtr = async;
+		async->setLockFree(lockFree);
+		async->setBufferSize(16);
+		async->addAppender(batchPtr);
+		async->activateOptions();
+
+		LoggerPtr logger = isolatedLogger(_T("batch"), async);
+		logger->info(_T("e0"));
+		batch->entered.wait();
+
+		for (int i = 1; i <= 10; i++)
+		{
+			logger->info(message(_T("e"), i));
+		}
+
+		batch->open = true;
+		batch->gate.post();
+		async->close();
+		logger->removeAllAppenders();
+
+		// the events piled up behind e0 are handed over in one batch
+		std::vector<int> expected;
+		expected.push_back(1);
+		expected.push_back(10);
+		CHECK(batch->batches == expected);
+		CHECK(inOrder(batch, _T("e"), 0, 10));
+		CHECK(async->getDiscardedCount() == 0);
+
+		return failures;
+	}
+}
+
+int ringBufferTest()
+{
+	int failures = 0;
+	LoggerPtr logger = Logger::getLogger(_T("ringbuffer"));
+
+	RingBufferPtr rb = new RingBuffer(5);
+	CHECK(rb->getMaxSize() == 8);
+	CHECK(rb->isEmpty());
+
+	// the positions wrap around the slots many times, the events are
+	// consumed in the order they were offered
+	int offered = 0, consumed = 0;
+	for (int round = 0; round < 100; round++)
+	{
+		for (int i = 0; i < 6; i++)
+		{
+			LoggingEvent event(logger, Level::INFO,
+				message(_T("r"), offered++));
+			CHECK(rb->offer(event));
+		}
+
+		CHECK(rb->length() == 6);
+
+		for (int i = 0; i < 6; i++)
+		{
+			LoggingEvent * event = rb->get();
+			CHECK(event != 0);
+			if (event != 0)
+			{
+				CHECK(event->getRenderedMessage()
+					== message(_T("r"), consumed));
+				rb->release(event);
+			}
+
+			consumed++;
+		}
+
+		CHECK(rb->isEmpty());
+		CHECK(rb->get() == 0);
+	}
+
+	// a full buffer refuses the event instead of overwriting one
+	for (int i = 0; i < 8; i++)
+	{
+		LoggingEvent event(logger, Level::INFO, message(_T("f"), i));
+		CHECK(rb->offer(event));
+	}
+
+	LoggingEvent extra(logger, Level::INFO, _T("extra"));
+	CHECK(!rb->offer(extra));
+	CHECK(rb->length() == 8);
+
+	LoggingEvent * oldest = rb->get();
+	CHECK(oldest != 0 && oldest->getRenderedMessage() == _T("f0"));
+	if (oldest != 0)
+	{
+		rb->release(oldest);
+	}
+
+	CHECK(rb->offer(extra));
+
+	return failures;
+}
+
+int asyncAppenderTest()
+{
+	int failures = 0;
+
+	failures += blockingTest(false);
+	failures += blockingTest(true);
+	failures += overflowTest(false);
+	failures += overflowTest(true);
+	failures += batchTest(false);
+	failures += batchTest(true);
+
+	return failures;
+}
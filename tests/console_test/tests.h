@@ -0,0 +1,80 @@
+/***************************************************************************
+                          tests.h  -  console_test declarations
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_TESTS_H
+#define _LOG4CXX_TESTS_H
+
+#include <log4cxx/helpers/tchar.h>
+#include <iostream>
+
+/**
+Count a failure and print the expression if <code>expr</code> is false.
+Each test function declares a local <code>failures</code> counter and
+returns it.
+*/
+#define CHECK(expr) \
+	if (!(expr)) { \
+	std::cerr << __FILE__ << ":" << __LINE__ << ": " << #expr \
+		<< " failed" << std::endl; \
+	failures++; }
+
+/** Runs the disabled statements for a while and prints their cost. */
+int disabledStatementBenchmark();
+
+/** Wraps the positions of a RingBuffer around and fills it. */
+int ringBufferTest();
+
+/** Logs through AsyncAppender until it blocks, overflows or batches. */
+int asyncAppenderTest();
+
+/** Checks the verdicts of the compiled filters of an appender. */
+int filterTest();
+
+/** Checks the events let through and reported by RateLimitFilter. */
+int rateLimitFilterTest();
+
+/** Checks the series collapsed and reported by DuplicateMessageFilter. */
+int duplicateMessageFilterTest();
+
+/** Checks the NDC frames shared by the events and the threads. */
+int ndcTest();
+
+/** Checks the MDC maps shared by the events and copied on write. */
+int mdcTest();
+
+/** Reads back the files written by FileAppender. */
+int fileAppenderTest();
+
+/** Reads back the files written by MappedFileAppender. */
+int mappedFileAppenderTest();
+
+/** Checks the loggers and the levels of the Hierarchy. */
+int hierarchyTest();
+
+/** Copies events, sends them through a socket and rejects the
+malformed ones. */
+int loggingEventTest();
+
+/** Formats events with the compiled programs of PatternLayout. */
+int patternLayoutTest();
+
+/** Checks the numbers and names of the threads printed by the events. */
+int threadIdentityTest();
+
+/** Formats events outside of the lock of a WriterAppender. */
+int writerAppenderTest();
+
+#endif //_LOG4CXX_TESTS_H
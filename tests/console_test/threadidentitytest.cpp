@@ -0,0 +1,124 @@
+/***************************************************************************
+              threadidentitytest.cpp  -  ThreadIdentity name tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/threadidentity.h>
+#include <log4cxx/helpers/thread.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+namespace
+{
+	tstring toText(unsigned long id)
+	{
+		tostringstream text;
+		text << id;
+		return text.str();
+	}
+
+	/** Names itself and keeps the thread of an event, then posts
+	<code>done</code>. */
+	class Worker : public Thread
+	{
+	public:
+		Worker(unsigned long& id, tstring& before, tstring& after,
+			Semaphore& done)
+		: id(id), before(before), after(after), done(done)
+		{
+		}
+
+		void run()
+		{
+			LoggerPtr logger = Logger::getLogger(_T("threadidentity"));
+			id = ThreadIdentity::getCurrent()->getId();
+
+			LoggingEvent unnamed(logger, Level::INFO, _T("unnamed"));
+			ThreadIdentity::setCurrentName(_T("worker"));
+			LoggingEvent named(logger, Level::INFO, _T("named"));
+
+			before = unnamed.getThreadName();
+			after = named.getThreadName();
+			done.post();
+		}
+
+	protected:
+		unsigned long& id;
+		tstring& before;
+		tstring& after;
+		Semaphore& done;
+	};
+}
+
+int threadIdentityTest()
+{
+	int failures = 0;
+	LoggerPtr logger = Logger::getLogger(_T("threadidentity"));
+
+	// an unnamed thread prints its number
+	ThreadIdentity::setCurrentName(_T(""));
+	unsigned long id = ThreadIdentity::getCurrent()->getId();
+	CHECK(id != 0);
+
+	LoggingEvent unnamed(logger, Level::INFO, _T("unnamed"));
+	CHECK(unnamed.getThreadId() == id);
+	CHECK(unnamed.getThreadName() == toText(id));
+
+	// renaming keeps the number, and the events logged before keep
+	// the previous text
+	ThreadIdentity::setCurrentName(_T("main"));
+	CHECK(ThreadIdentity::getCurrent()->getId() == id);
+	CHECK(ThreadIdentity::getCurrent()->getName() == _T("main"));
+
+	LoggingEvent named(logger, Level::INFO, _T("named"));
+	CHECK(named.getThreadName() == _T("main"));
+	CHECK(unnamed.getThreadName() == toText(id));
+
+	PatternLayout layout(_T("[%t] [%-6t] [%.2t]"));
+	tstring output;
+	layout.format(output, named);
+	CHECK(output == _T("[main] [main  ] [in]"));
+
+	// another thread gets its own number and name
+	unsigned long workerId = 0;
+	tstring before, after;
+	Semaphore done;
+	Thread * worker = new Worker(workerId, before, after, done);
+	worker->start();
+	done.wait();
+
+	CHECK(workerId != 0 && workerId != id);
+	CHECK(before == toText(workerId));
+	CHECK(after == _T("worker"));
+	CHECK(ThreadIdentity::getCurrent()->getName() == _T("main"));
+
+	// an identity read from a socket is not registered
+	ThreadIdentityPtr remote = new ThreadIdentity(42, _T(""));
+	CHECK(remote->getText() == _T("42"));
+	remote = new ThreadIdentity(42, _T("remote"));
+	CHECK(remote->getText() == _T("remote"));
+
+	// an empty name reverts to the number
+	ThreadIdentity::setCurrentName(_T(""));
+	CHECK(ThreadIdentity::getCurrent()->getText() == toText(id));
+
+	return failures;
+}
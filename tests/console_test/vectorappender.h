@@ -0,0 +1,117 @@
+/***************************************************************************
+                          vectorappender.h  -  class VectorAppender
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#ifndef _LOG4CXX_TESTS_VECTOR_APPENDER_H
+#define _LOG4CXX_TESTS_VECTOR_APPENDER_H
+
+#include <log4cxx/appenderskeleton.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/semaphore.h>
+#include <vector>
+
+namespace log4cxx
+{
+	class VectorAppender;
+	typedef helpers::ObjectPtr<VectorAppender> VectorAppenderPtr;
+
+	/**
+	VectorAppender keeps the messages and the levels of the events it
+	appends, for the tests to check them.
+	*/
+	class VectorAppender : public AppenderSkeleton
+	{
+	public:
+		std::vector<tstring> messages;
+		std::vector<int> levels;
+
+		void close()
+		{
+			closeFilters();
+			closed = true;
+		}
+
+		bool requiresLayout()
+			{ return false; }
+
+		/**
+		Returns the number of messages starting with
+		<code>prefix</code>.
+		*/
+		int count(const tstring& prefix) const
+		{
+			int n = 0;
+			for (size_t i = 0; i < messages.size(); i++)
+			{
+				if (messages[i].compare(0, prefix.size(), prefix) == 0)
+				{
+					n++;
+				}
+			}
+
+			return n;
+		}
+
+		/** Returns the number of filter tables not deleted yet. */
+		int retiredFilterCount()
+			{ return retiredFilters.size(); }
+
+	protected:
+		void append(const spi::LoggingEvent& event)
+		{
+			messages.push_back(event.getRenderedMessage());
+			levels.push_back(event.getLevel().toInt());
+		}
+	}; // class VectorAppender
+
+	class GateAppender;
+	typedef helpers::ObjectPtr<GateAppender> GateAppenderPtr;
+
+	/**
+	GateAppender holds the thread appending an event until the test
+	opens the gate, so that the events logged meanwhile pile up in an
+	AsyncAppender.
+	*/
+	class GateAppender : public VectorAppender
+	{
+	public:
+		/** Posted when an event reaches the gate. */
+		helpers::Semaphore entered;
+
+		/** Posted by the test to let an event through. */
+		helpers::Semaphore gate;
+
+		/** Let all the events through from now on. */
+		volatile bool open;
+
+		GateAppender() : open(false)
+		{
+		}
+
+	protected:
+		void append(const spi::LoggingEvent& event)
+		{
+			if (!open)
+			{
+				entered.post();
+				gate.wait();
+			}
+
+			VectorAppender::append(event);
+		}
+	}; // class GateAppender
+}; // namespace log4cxx
+
+#endif //_LOG4CXX_TESTS_VECTOR_APPENDER_H
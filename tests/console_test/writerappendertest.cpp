@@ -0,0 +1,126 @@
+/***************************************************************************
+             writerappendertest.cpp  -  WriterAppender formatting tests
+                             -------------------
+    begin                : sam oct 17 2026
+    copyright            : (C) 2003 by Michael CATANZARITI
+    email                : mcatan@free.fr
+ ***************************************************************************/
+
+/***************************************************************************
+ * Copyright (C) The Apache Software Foundation. All rights reserved.      *
+ *                                                                         *
+ * This software is published under the terms of the Apache Software       *
+ * License version 1.1, a copy of which has been included with this        *
+ * distribution in the LICENSE.txt file.                                   *
+ ***************************************************************************/
+
+#include "tests.h"
+#include <log4cxx/logger.h>
+#include <log4cxx/level.h>
+#include <log4cxx/writerappender.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/helpers/thread.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+namespace
+{
+	/** Writes to a stream owned by the test. */
+	class StreamAppender : public WriterAppender
+	{
+	public:
+		StreamAppender(LayoutPtr layout, tostream * os)
+		: WriterAppender(layout, os)
+		{
+		}
+
+	protected:
+		void closeWriter()
+		{
+		}
+	};
+
+	/** Logs <code>count</code> events, then posts <code>done</code>. */
+	class Writer : public Thread
+	{
+	public:
+		Writer(const LoggerPtr& logger, int count, Semaphore& done)
+		: logger(logger), count(count), done(done)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < count; i++)
+			{
+				logger->info(_T("formatted outside of the lock"));
+			}
+
+			done.post();
+		}
+
+	protected:
+		LoggerPtr logger;
+		int count;
+		Semaphore& done;
+	};
+}
+
+int writerAppenderTest()
+{
+	int failures = 0;
+	const int writerCount = 4;
+	const int count = 500;
+
+	LoggerPtr logger = Logger::getLogger(_T("writer"));
+	logger->setLevel(Level::DEBUG);
+	logger->setAdditivity(false);
+
+	tostringstream output;
+	WriterAppender * appender = new StreamAppender(
+		new PatternLayout(_T("<%p %m>%n")), &output);
+	AppenderPtr appenderPtr = appender;
+	logger->addAppender(appender);
+
+	// the events are formatted without the appender lock while the
+	// layout and the threshold are replaced
+	Semaphore done;
+	for (int w = 0; w < writerCount; w++)
+	{
+		Thread * writer = new Writer(logger, count, done);
+		writer->start();
+	}
+
+	int finished = 0;
+	while (finished < writerCount)
+	{
+		appender->setLayout(new PatternLayout(_T("<%-4p %m>%n")));
+		appender->setThreshold(Level::DEBUG);
+		appender->setLayout(new PatternLayout(_T("<%p %m>%n")));
+		appender->setThreshold(Level::ALL);
+
+		while (finished < writerCount && done.tryWait())
+		{
+			finished++;
+		}
+	}
+
+	// each event is written whole, on its own line
+	tstring text = output.str();
+	const tstring line = _T("<INFO formatted outside of the lock>");
+	int lines = 0;
+	tstring::size_type start = 0, end;
+	while ((end = text.find(_T('\n'), start)) != tstring::npos)
+	{
+		CHECK(text.substr(start, end - start) == line);
+		lines++;
+		start = end + 1;
+	}
+
+	CHECK(start == text.size());
+	CHECK(lines == writerCount * count);
+
+	logger->removeAppender(appender);
+	return failures;
+}